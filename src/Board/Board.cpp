@@ -212,8 +212,8 @@ void Board::makeMove(Move &m)
     halfMoveClock++;
     ply++;
     
-    // Position Hash Update features (EP, MoveC, Castling)
-    uint64_t newPoshHash = zobristKey ^ (static_cast<bool>(sideToMove) ? PieceMap::blackSideToMove : 0);
+    // Position Hash Update features (Side to move, EP, Castling)
+    uint64_t newPoshHash = zobristKey ^ PieceMap::blackSideToMove;
     if (oldEnPassant != -1) newPoshHash ^= PieceMap::enPassantsMap[oldEnPassant % 8];
     while (oldCastlingRights) newPoshHash ^= PieceMap::castlingRightsMap[pop_1st(oldCastlingRights)];
 
@@ -269,16 +269,10 @@ void Board::makeMove(Move &m)
     {
         halfMoveClock = 0;
 
-        if ( m.isEpCapture() )
-        {
-            bitboards[bbCaptured] ^= (minBitSet << ( m.TargetSq() + (static_cast<bool>(sideToMove) ? 8 : -8 ) ));
-        }
-        else
-        {
-            bitboards[bbCaptured] ^= targetSq;
-        }
+        const int capturedSq = m.isEpCapture() ? m.TargetSq() + (static_cast<bool>(sideToMove) ? 8 : -8 ) : m.TargetSq();
+        bitboards[bbCaptured] ^= bitBoardSet(capturedSq);
 
-        newPoshHash ^= PieceMap::pieceMap[bbCaptured - align][m.TargetSq()];
+        newPoshHash ^= PieceMap::pieceMap[bbCaptured - align][capturedSq];
         captured = static_cast<PieceDescriptor>(bbCaptured);
     }
     else if ( m.isPromotion() )
@@ -304,14 +298,14 @@ void Board::makeMove(Move &m)
         newPoshHash ^= PieceMap::pieceMap[std::to_underlying(PieceDescriptor::bRook) - WM - align][std::countr_zero(targetSq >> 2)];
         setBbUs( Piece::Rook,  WM ? WhiteRookQueenPos : BlackRookQueenPos);
         setBbUs(Piece::Rook, targetSq << 1);
-        newPoshHash ^= PieceMap::pieceMap[std::to_underlying(PieceDescriptor::bRook) - WM - align][std::countr_zero(targetSq << 3)];
+        newPoshHash ^= PieceMap::pieceMap[std::to_underlying(PieceDescriptor::bRook) - WM - align][std::countr_zero(targetSq << 1)];
     }
     else if ( m.isKingCastle() )
     {
         newPoshHash ^= PieceMap::pieceMap[std::to_underlying(PieceDescriptor::bRook) - WM - align][std::countr_zero(targetSq << 1)];
         setBbUs( Piece::Rook,  WM ? WhiteRookKingPos : BlackRookKingPos);
         setBbUs(Piece::Rook, targetSq >> 1);
-        newPoshHash ^= PieceMap::pieceMap[std::to_underlying(PieceDescriptor::bRook) - WM - align][std::countr_zero(targetSq >> 2)];
+        newPoshHash ^= PieceMap::pieceMap[std::to_underlying(PieceDescriptor::bRook) - WM - align][std::countr_zero(targetSq >> 1)];
     }
 
     recomputeSideOccupancies();
@@ -389,6 +383,44 @@ void Board::unmakeMove()
     sideToMove = prevSTM;
 }
 
+void Board::makeNullMove()
+{
+    uint64_t newPoshHash = zobristKey ^ PieceMap::blackSideToMove;
+    if (enPassant != -1) newPoshHash ^= PieceMap::enPassantsMap[enPassant % 8];
+
+    enPassant = -1;
+    ply++;
+
+    // repetitions can't be traced through the null move
+    halfMoveClock = 0;
+
+    zobristKey = newPoshHash;
+
+    history[ply] = zobristKey;
+
+    shortMem[ply].moveHash      = zobristKey;
+    shortMem[ply].capturedPiece = PieceDescriptor::nWhite; // 0 - no capture
+    shortMem[ply].castling      = castlingRights;
+    shortMem[ply].ep            = static_cast<int8_t>(enPassant);
+    shortMem[ply].halfmove      = halfMoveClock;
+    shortMem[ply].move          = 0;
+
+    sideToMove = (sideToMove == pColor::White) ? pColor::Black : pColor::White;
+}
+
+void Board::unmakeNullMove()
+{
+    if ( ply == 0 ) return;
+
+    ply--;
+    halfMoveClock  = shortMem[ply].halfmove;
+    castlingRights = shortMem[ply].castling;
+    enPassant      = shortMem[ply].ep;
+    zobristKey     = shortMem[ply].moveHash;
+
+    sideToMove = (sideToMove == pColor::White) ? pColor::Black : pColor::White;
+}
+
 // ---------------------------------
 // Move make Helpers
 // ---------------------------------
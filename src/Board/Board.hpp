@@ -110,7 +110,8 @@ public:
     static constexpr size_t enPassantCount = 2; // for white and black pawns
     static constexpr size_t castlingCount = 4; // for white and black kings and rooks
 
-    static constexpr size_t MAXMoveHistory = 256;
+    // game plies + search plies, both history arrays are indexed by ply (the search keeps below it)
+    static constexpr size_t MAXMoveHistory = 1024;
 
     // Rook default positions for castling moves
     static constexpr uint64_t WhiteRookQueenPos = 1;
@@ -121,7 +122,7 @@ public:
     // e.g. in PieceMap indexing we have to subtract 2, becase Piece's bitboards start from third idx.
     static constexpr size_t align = 2;
 
-    static constexpr size_t maxGameMoves = 512; // game moves + depth moves + max moves in one position
+    static constexpr size_t maxGameMoves = MAXMoveHistory;
     
     // ---------------------------------
     // getters
@@ -155,7 +156,7 @@ public:
     int enPassant = -1;         // enPassant Square, -1 - if no enPassant
     uint8_t castlingRights = 0x0F; // 0b00001(white kingside)1(white queenside)1(black kingside)1(balck queenside)
 
-    std::array<Undo, MAXMoveHistory> shortMem;   // MAXMoveHistory should be as big as the most depth search
+    std::array<Undo, MAXMoveHistory> shortMem;   // undo records of the game and the search line
     size_t ply = 0;                             // half move idx of history array;
 
     // ---------------------------------
@@ -177,6 +178,13 @@ public:
     void makeMove(Move &m);
     void unmakeMove();
 
+    // pass the turn: side to move flip, EP cleared, bitboards untouched
+    // (stored in shortMem with move = 0, have to be undone by unmakeNullMove)
+    void makeNullMove();
+    void unmakeNullMove();
+
+    [[nodiscard]] bool isLastMoveNull() const { return ply > 0 && shortMem[ply].move == 0; }
+
     // ---------------------------------
     // Move make Helpers
     // ---------------------------------
@@ -237,6 +245,12 @@ public:
         return bitboards[static_cast<size_t>(pieceType) + static_cast<size_t>(sideToMove)];
     }
 
+    // any piece except pawns and king (zugzwang danger when false)
+    bool hasNonPawnMaterial() const
+    {
+        return bbUs() & ~(bbUs(Piece::Pawn) | bbUs(Piece::King));
+    }
+
     uint64_t bbThem(Piece pieceType) const
     {
         return bitboards[static_cast<size_t>(pieceType) + 1 - static_cast<size_t>(sideToMove)];
@@ -13,57 +13,124 @@
 #include "TranspositionTable.h"
 #include "Board.hpp"
 #include "BitOperation.hpp"
-#include "MoveParser.h"
 
+#include <algorithm>
+#include <iomanip>
 #include <limits>
+#include <thread>
+
 
+static constexpr int INF = std::numeric_limits<int>::max();     // -INF is still a valid int, unlike int min
+// mate scores: MATE_SCORE - (plies from the root to the mate), everything above MATE_BOUND is a mate
+static constexpr int MATE_SCORE = 100000;
+static constexpr int MATE_BOUND = MATE_SCORE - 1000;
 
-static constexpr int INF = std::numeric_limits<int>::max();
+// move ordering tiers
+static constexpr int PV_MOVE_SCORE   = 3000000;
+static constexpr int HASH_MOVE_SCORE = 2000000;
+static constexpr int CAPTURE_SCORE   = 1000000;
+static constexpr int PROMOTION_SCORE = 950000;
+static constexpr std::array<int, 2> KILLER_SCORE = { 900000, 800000 };
+static constexpr int COUNTER_MOVE_SCORE = 700000;
 
 
-void Search::orderMoves(std::array<Move, 256> &moves, int count, Move hashMove, ChessRules& rules) 
+[[nodiscard]] static bool sameMove(Move a, Move b)
 {
-    struct ScoredMove
-    {
-        Move move;
-        int score;
-        
-        bool operator>(const ScoredMove& other) const 
-        {
-            return score > other.score;
-        }
-    };
+    return static_cast<uint16_t>(a.getPackedMove()) == static_cast<uint16_t>(b.getPackedMove());
+}
+
+// TT keeps mate scores as the distance from the stored node, not from the root
+[[nodiscard]] static int scoreToTT(int score, int ply)
+{
+    if (score >= MATE_BOUND)  return score + ply;
+    if (score <= -MATE_BOUND) return score - ply;
+    return score;
+}
 
-    std::array<ScoredMove, 256> scoredMoves;
+[[nodiscard]] static int scoreFromTT(int score, int ply)
+{
+    if (score >= MATE_BOUND)  return score - ply;
+    if (score <= -MATE_BOUND) return score + ply;
+    return score;
+}
+
+[[nodiscard]] static std::string moveToUci(Move move)
+{
+    std::string moveStr = SimpleParser::moveToString(move.OriginSq(), move.TargetSq());
+    if (char promChar = SimpleParser::promotionTypeToChar(move.getType()); 
+        promChar != '\0')
+    { 
+        moveStr += promChar;
+    }
+    return moveStr;
+}
+
+
+void SearchWorker::orderMoves(std::array<Move, 256> &moves, int count, Move hashMove, Move pvMove) 
+{
+    const int ply = searchPly();
+    auto &scoredMoves = stack[ply].scoredMoves;
+    const auto &killers = stack[ply].killers;
+    const auto &historyUs = history[std::to_underlying(board.sideToMove)];
+
+    const StackEntry *prev = previousMove(1);
+    const Move counterMove = prev ? counterMoves[prev->movedPiece][Move{prev->currentMove}.TargetSq()] : Move{0};
+    const PieceToHistory *cont1 = continuation(1);
+    const PieceToHistory *cont2 = continuation(2);
 
     for (int i = 0; i < count; ++i) 
     {
         int score = 0;
         Move currentMove = moves[i];
 
-        if ((currentMove.TargetSq() == hashMove.TargetSq()) && (currentMove.OriginSq() == hashMove.OriginSq())) 
+        if (pvMove.getPackedMove() != 0 && sameMove(currentMove, pvMove))
+        {
+            score = PV_MOVE_SCORE;
+        }
+        else if ((currentMove.TargetSq() == hashMove.TargetSq()) && (currentMove.OriginSq() == hashMove.OriginSq())) 
         {
-            score = 2000000;
+            score = HASH_MOVE_SCORE;
         }
         else if (currentMove.isAnyCapture()) 
         {
-            PieceDescriptor aggressor = static_cast<PieceDescriptor>(
-                rules._board.getBitboard(bitBoardSet(currentMove.OriginSq()))
-            );
-            
-            PieceDescriptor victim;
-            if (currentMove.isEpCapture()) 
-            {
-                victim = PieceDescriptor::wPawn; 
-            } 
-            else 
+            // MVV-LVA, with useCaptureHistory + capture history of this (piece, to, victim)
+            const uint8_t piece = movedPiece(currentMove);
+            const size_t victim = capturedType(currentMove);
+            const auto victimDescriptor = static_cast<PieceDescriptor>(Board::align + (2 * victim));
+
+            score = (Evaluation::getPieceValue(victimDescriptor) * 10) - Evaluation::getPieceValue(static_cast<PieceDescriptor>(piece)) + CAPTURE_SCORE;
+
+            if constexpr (Search::useCaptureHistory)
             {
-                victim = static_cast<PieceDescriptor>(
-                    rules._board.getBitboard(bitBoardSet(currentMove.TargetSq()))
-                );
+                score += captureHistory[piece][currentMove.TargetSq()][victim] / Search::captureHistoryDivisor;
             }
+        }
+        else if (currentMove.isPromotion())
+        {
+            score = PROMOTION_SCORE;
+        }
+        else if (sameMove(currentMove, killers[0]))
+        {
+            score = KILLER_SCORE[0];
+        }
+        else if (sameMove(currentMove, killers[1]))
+        {
+            score = KILLER_SCORE[1];
+        }
+        else if (prev && sameMove(currentMove, counterMove))
+        {
+            score = COUNTER_MOVE_SCORE;
+        }
+        else
+        {
+            score = historyUs[currentMove.OriginSq()][currentMove.TargetSq()];
 
-            score = (Evaluation::getPieceValue(victim) * 10) - Evaluation::getPieceValue(aggressor) + 10000; 
+            if (cont1 || cont2)
+            {
+                const uint8_t piece = movedPiece(currentMove);
+                if (cont1) score += (*cont1)[piece][currentMove.TargetSq()];
+                if (cont2) score += (*cont2)[piece][currentMove.TargetSq()];
+            }
         }
         
         scoredMoves[i] = {currentMove, score};
@@ -82,245 +149,919 @@ void Search::orderMoves(std::array<Move, 256> &moves, int count, Move hashMove,
     }
 }
 
-[[nodiscard]] int Search::quiescence(ChessRules &rules, int alpha, int beta, bool isMaxTurn)
+[[nodiscard]] int SearchWorker::staticEval()
 {
-    int stand_pat = Evaluation::evaluate(rules);
+    int score = Evaluation::evaluate(rules);
+    return (board.sideToMove == pColor::White) ? score : -score;
+}
+
+[[nodiscard]] int SearchWorker::quiescence(int alpha, int beta)
+{
+    countNode();
+
+    const int ply = searchPly();
+    pvLength[ply] = ply;
+    seldepth = std::max(seldepth, ply);
 
-    if (isMaxTurn)
+    if (_search.stopRequest) return 0;
+
+    if (ply >= leafPly) return rules.isCheck() ? 0 : staticEval();
+
+    StackEntry &frame = stack[ply];
+    auto &moves = frame.moves;
+
+    using TTEntry = TranspositionTable::Entry;
+
+    // every qsearch entry is depth 0, so any stored depth is deep enough
+    TTEntry ttEntry = _search._TT.probe(board.zobristKey);
+    if (ttEntry.isValid()) ttEntry.score = scoreFromTT(ttEntry.score, ply);
+
+    if (ttEntry.isValid()) 
+    {
+        if (ttEntry.type == TTEntry::Type::EXACT)                                return ttEntry.score;
+        if (ttEntry.type == TTEntry::Type::LOWERBOUND && ttEntry.score >= beta)  return ttEntry.score;
+        if (ttEntry.type == TTEntry::Type::UPPERBOUND && ttEntry.score <= alpha) return ttEntry.score;
+    }
+
+    const bool inCheck = rules.isCheck();
+    const int originAlpha = alpha;
+
+    int count = 0;
+    int bestScore = -INF;
+    int standPat = -INF;
+
+    if (inCheck)
     {
-        if (stand_pat >= beta) return beta;
-        if (stand_pat > alpha) alpha = stand_pat;
+        // no stand pat in check - every evasion has to be tried
+        count = MoveGen::generateLegalMoves(rules, moves.data());
+
+        if (count == 0) return -MATE_SCORE + ply;
     }
     else
     {
-        if (stand_pat <= alpha) return alpha;
-        if (stand_pat < beta) beta = stand_pat;
+        standPat = frame.evalReady ? frame.staticEval : staticEval();
+        frame.staticEval = standPat;
+
+        if (standPat >= beta) return standPat;
+        if (standPat > alpha) alpha = standPat;
+
+        bestScore = standPat;
+
+        Move *endPtr = MoveGen::generate<Gen::Captures>(rules, moves.data());
+        count = static_cast<int>(endPtr - moves.data());
     }
 
-    // for now only fighting captures check
-    std::array<Move, 256> captures;
-    Move *endPtr = MoveGen::generate<Gen::Captures>(rules, captures.data());
-    auto count = static_cast<int>(endPtr - captures.data());
+    orderMoves(moves, count, ttEntry.isValid() ? ttEntry.move : Move{0});
 
-    orderMoves(captures, count, Move{0}, rules);
+    Move bestMove = Move{0};
 
     for (int i = 0; i < count; ++i)
     {
-        rules._board.makeMove(captures[i]);
+        // Delta pruning - even winning the captured piece with a margin does not reach alpha
+        if (!inCheck && !moves[i].isPromotion())
+        {
+            const auto victim = static_cast<PieceDescriptor>(Board::align + (2 * capturedType(moves[i])));
+
+            if (standPat + Evaluation::getPieceValue(victim) + Search::deltaMargin <= alpha) continue;
+        }
+
+        frame.currentMove = moves[i];
+        frame.movedPiece = movedPiece(moves[i]);
+
+        board.makeMove(moves[i]);
         
-        int score = quiescence(rules, alpha, beta, !isMaxTurn);
+        int score = -quiescence(-beta, -alpha);
         
-        rules._board.unmakeMove();
+        board.unmakeMove();
+
+        if (_search.stopRequest) return 0;
 
-        if (isMaxTurn)
+        if (score > bestScore)
         {
-            if (score >= beta) return beta;
+            bestScore = score;
+            bestMove = moves[i];
+
             if (score > alpha) alpha = score;
-        }
-        else
-        {
-            if (score <= alpha) return alpha;
-            if (score < beta) beta = score;
+            if (score >= beta) break;
         }
     }
 
-    return isMaxTurn ? alpha : beta;
+    TTEntry::Type type = (bestScore >= beta)        ? TTEntry::Type::LOWERBOUND
+                       : (bestScore > originAlpha)  ? TTEntry::Type::EXACT
+                                                    : TTEntry::Type::UPPERBOUND;
+    _search._TT.save(board.zobristKey, 0, scoreToTT(bestScore, ply), type, bestMove);
+
+    return bestScore;
 }
 
-[[nodiscard]] int Search::minMax(ChessRules &rules, int depth, int alpha, int beta, bool isMaxTurn)
+template<SearchWorker::NodeType NT>
+[[nodiscard]] int SearchWorker::negamax(int depth, int alpha, int beta)
 {
-    nodes++;
+    constexpr bool rootNode = (NT == NodeType::Root);
+    constexpr bool pvNode = (NT == NodeType::Root || NT == NodeType::PV);
+
+    // the root moves are searched - MultiPV taken moves skipped, no repetition / mate distance checks
+    constexpr bool rootMoves = (rootNode || NT == NodeType::RootExclusion);
 
-    if ((nodes & 2047) == 0) {
-        checkTime();
+    // the first move of a PV node gets the full window, everything else a null one
+    constexpr NodeType firstChild = pvNode ? NodeType::PV : NodeType::NonPV;
+
+    if (depth <= 0)
+    {
+        return quiescence(alpha, beta);
     }
 
-    if ( rules.isRepetition() ) return 0;   // when 2fold repetition
+    countNode();
+
+    const int ply = searchPly();
+    pvLength[ply] = ply;
+    seldepth = std::max(seldepth, ply);
+
+    if (ply >= leafPly) return rules.isCheck() ? 0 : staticEval();
+
+    StackEntry &frame = stack[ply];
+    auto &moves = frame.moves;
+    const Move excludedMove = frame.excludedMove;
+
+    if constexpr (!rootMoves)
+    {
+        if ( rules.isRepetition() ) return 0;   // when 2fold repetition
+
+        // Mate distance pruning - no line from here beats a mate already found closer to the root
+        alpha = std::max(alpha, -MATE_SCORE + ply);
+        beta = std::min(beta, MATE_SCORE - ply - 1);
+        if (alpha >= beta) return alpha;
+    }
 
     using TTEntry = TranspositionTable::Entry;
     
-    TTEntry ttEntry = _TT.probe(rules._board.zobristKey);
+    TTEntry ttEntry = _search._TT.probe(board.zobristKey);
+    if (ttEntry.isValid()) ttEntry.score = scoreFromTT(ttEntry.score, ply);
+
+    // exclusion search (singular extension) shares the key with the full node - no TT cutoffs nor writes
+    const bool excluded = (excludedMove.getPackedMove() != 0);
+
+    // MultiPV lines after the first search only a part of the root moves - no TT writes either
+    const bool storeTT = !excluded && !(rootNode && multiPvIdx > 0);
     
-    if (ttEntry.isValid() && ttEntry.depth >= depth) 
+    // no cutoffs in PV nodes (root included) - a cutoff would end the PV here,
+    // and the next iteration would have no line to follow
+    if (!pvNode && !excluded && ttEntry.isValid() && ttEntry.depth >= depth) 
     {
         if (ttEntry.type == TTEntry::Type::EXACT)                                return ttEntry.score;
         if (ttEntry.type == TTEntry::Type::LOWERBOUND && ttEntry.score >= beta)  return ttEntry.score;
         if (ttEntry.type == TTEntry::Type::UPPERBOUND && ttEntry.score <= alpha) return ttEntry.score;
     }
 
-    Move hashMove = ttEntry.isValid() ? ttEntry.move : Move{0};
+    Move hashMove = (ttEntry.isValid() && ttEntry.move.getPackedMove() != 0) ? ttEntry.move : Move{0};
+
+    // the eval generates moves for mobility - re-entries of this ply take it from the frame
+    const bool inCheck = rules.isCheck();
+    const int eval = frame.evalReady ? frame.staticEval : (inCheck ? -INF : staticEval());
+    frame.staticEval = eval;
 
-    if (depth == 0)
+    // Reverse futility pruning (static null move) - eval is so far above beta
+    // that no quiet reply at this depth is going to bring it back
+    if (!pvNode && !inCheck && !excluded && depth <= Search::rfpMaxDepth && std::abs(beta) < MATE_BOUND &&
+        eval - (Search::rfpMargin * depth) >= beta)
     {
-        return quiescence(rules, alpha, beta, isMaxTurn);
+        return eval;
     }
 
-    std::array<Move, 256> moves;
-    int moveCount = MoveGen::generateLegalMoves(rules, moves.data());
+    // Razoring - hopeless frontier nodes drop into quiescence
+    if (!pvNode && !inCheck && !excluded && depth <= Search::razorMaxDepth && 
+        eval + Search::razorMargins[depth] < alpha)
+    {
+        frame.evalReady = true;
+        int qScore = quiescence(alpha, beta);
+        frame.evalReady = false;
+        if (qScore <= alpha) return qScore;
+    }
 
-    if (moveCount == 0)
+    // Null move pruning - when passing the turn still fails high, so does the real move
+    // not in check, not twice in a row, not in pawn-only endings (zugzwang)
+    if (!pvNode && !inCheck && !excluded && depth >= Search::nmpMinDepth && !board.isLastMoveNull() &&
+        board.hasNonPawnMaterial() && nullMoveAllowed() && eval >= beta)
     {
-        // Mate
-        if (rules.isCheck()) 
+        const int R = Search::nmpBaseReduction + depth / Search::nmpDepthDivisor;
+
+        frame.currentMove = Move{0};
+        frame.movedPiece = 0;
+
+        board.makeNullMove();
+        int nullScore = -negamax<NodeType::NonPV>(std::max(depth - 1 - R, 0), -beta, -beta + 1);
+        board.unmakeNullMove();
+
+        if (_search.stopRequest) return 0;
+
+        if (nullScore >= beta)
+        {
+            // unproven mate scores are not returned
+            if (nullScore >= MATE_BOUND) nullScore = beta;
+
+            if (depth < Search::nmpVerificationDepth) return nullScore;
+
+            // verification search (without null moves for this side in the next plies)
+            nmpMinPly = static_cast<int>(board.ply) + (3 * (depth - R) / 4);
+            nmpColor = board.sideToMove;
+
+            frame.evalReady = true;
+            int verified = negamax<NodeType::NonPV>(std::max(depth - R, 1), beta - 1, beta);
+            frame.evalReady = false;
+
+            nmpMinPly = 0;
+
+            if (verified >= beta) return nullScore;
+        }
+    }
+
+    // No hash move at a deep node - ordering has no hint
+    if (!excluded && hashMove.getPackedMove() == 0)
+    {
+        if constexpr (Search::useIID)
         {
-            const int MATE_SCORE = 100000; 
+            // Internal iterative deepening - a shallow search seeds the TT move
+            if (pvNode && depth >= Search::iidMinDepth)
+            {
+                const bool savedFollowPv = std::exchange(followPv, false);
+                frame.evalReady = true;
+                (void)negamax<NT>(depth - Search::iidReduction, alpha, beta);
+                frame.evalReady = false;
+                followPv = savedFollowPv;
 
-            if (isMaxTurn) 
-                return -MATE_SCORE - depth;
-            else 
-                return MATE_SCORE + depth;
+                if (_search.stopRequest) return 0;
+
+                ttEntry = _search._TT.probe(board.zobristKey);
+                if (ttEntry.isValid()) hashMove = ttEntry.move;
+            }
         }
-        // Pat
-        else 
+        else
         {
-            return 0;
+            // Internal iterative reduction - such node is probably not that important, search it shallower
+            if (depth >= Search::iirMinDepth) depth--;
         }
     }
 
+    // extensions are capped at twice the iteration depth to keep the tree finite
+    const bool canExtend = searchPly() < 2 * rootDepth;
+
+    // Singular extension - the TT move is much better than all the others:
+    // the rest searched at reduced depth fail low against ttScore - margin.
+    // Done before the move generation - the exclusion search reuses this ply's stack entry.
+    bool singular = false;
+    if (canExtend && !excluded && depth >= Search::singularMinDepth && hashMove.getPackedMove() != 0 &&
+        !(rootNode && isLineTaken(hashMove)) && ttEntry.depth >= depth - 3 && ttEntry.type != TTEntry::Type::UPPERBOUND && std::abs(ttEntry.score) < MATE_BOUND)
+    {
+        const int singularBeta = ttEntry.score - (Search::singularMargin * depth);
+
+        const bool savedFollowPv = std::exchange(followPv, false);
+        frame.excludedMove = hashMove;
+        frame.evalReady = true;
+        constexpr NodeType exclusionNode = rootNode ? NodeType::RootExclusion : NodeType::NonPV;
+        const int singularScore = negamax<exclusionNode>((depth - 1) / 2, singularBeta - 1, singularBeta);
+        frame.evalReady = false;
+        frame.excludedMove = Move{0};
+        followPv = savedFollowPv;
+
+        if (_search.stopRequest) return 0;
+
+        if (singularScore < singularBeta)
+        {
+            singular = true;
+        }
+        // multi-cut - more than one move beats beta
+        else if (singularBeta >= beta)
+        {
+            return singularBeta;
+        }
+    }
+
+    int moveCount = MoveGen::generateLegalMoves(rules, moves.data());
+
+    if (moveCount == 0)
+    {
+        // Mate (side to move is mated) or Pat
+        return inCheck ? (-MATE_SCORE + ply) : 0;
+    }
+
+    // the previous iteration PV is searched first as long as we are on it
+    // (only the first moves of PV nodes lead there, non-PV nodes never follow it)
+    Move pvMove = Move{0};
+    if (pvNode && followPv)
+    {
+        if (ply < prevPvLength) pvMove = prevPv[ply];
+        else followPv = false;
+    }
+
     // order Moves
-    orderMoves(moves, moveCount, hashMove, rules);
+    orderMoves(moves, moveCount, hashMove, pvMove);
+
+    if (pvNode && followPv && !sameMove(moves[0], pvMove)) followPv = false;
+
+    int bestScore = -INF;
+    Move bestMove = Move{0};
+    const int originAlpha = alpha;
+
+    auto &quietsTried = frame.quietsTried;
+    int quietCount = 0;
+    auto &capturesTried = frame.capturesTried;
+    int captureCount = 0;
+
+    // moves past the excluded / MultiPV taken skips - the index PVS, futility and LMR go by,
+    // so skipping moves[0] doesn't take the first move status away from the next one
+    int searchedMoves = 0;
+
+    // Futility pruning - quiet moves can't raise eval enough to reach alpha
+    const bool futile = !pvNode && !inCheck && depth <= Search::futilityMaxDepth &&
+                        std::abs(alpha) < MATE_BOUND && eval + Search::futilityMargins[depth] <= alpha;
+
+    for (int i = 0; i < moveCount; ++i)
+    {
+        if (excluded && sameMove(moves[i], excludedMove)) continue;
+        if constexpr (rootMoves)
+        {
+            if (isLineTaken(moves[i])) continue;
+        }
 
-    if (isMaxTurn)
-    {        
-        int maxScore = std::numeric_limits<int>::min();
-        Move bestMove = Move{0};
-        int originAlpha = alpha;
+        const int moveIndex = searchedMoves++;
+        const bool isQuiet = !moves[i].isAnyCapture() && !moves[i].isPromotion();
 
-        for (int i = 0; i < moveCount; ++i)
+        // singular - only the hash move
+        int extension = (singular && sameMove(moves[i], hashMove)) ? 1 : 0;
+
+        frame.currentMove = moves[i];
+        frame.movedPiece = movedPiece(moves[i]);
+
+        const uint64_t nodesBefore = nodes.load(std::memory_order_relaxed);
+
+        board.makeMove(moves[i]);
+
+        const bool givesCheck = rules.isCheck();
+
+        // Check extension
+        if (canExtend && givesCheck) extension = 1;
+
+        const int newDepth = depth - 1 + extension;
+
+        if (futile && moveIndex > 0 && isQuiet && !givesCheck)
         {
-            rules._board.makeMove(moves[i]);
+            board.unmakeMove();
+            continue;
+        }
+
+        int score;
 
-            int score = minMax(rules, depth - 1, alpha, beta, false);
+        // PVS - the first move with the full window, the rest have to prove
+        // with a null window that they are better, re-search only on fail-high
+        if (moveIndex == 0)
+        {
+            score = -negamax<firstChild>(newDepth, -beta, -alpha);
+        }
+        else
+        {
+            // Late move reductions - quiet moves late in the ordering are searched shallower first
+            int R = 0;
+            if (depth >= Search::lmrMinDepth && moveIndex >= Search::lmrMinMoveIndex && isQuiet && !inCheck && !givesCheck)
+            {
+                R = Search::lmrReductions[std::min(depth, 63)][std::min(moveIndex, 63)];
+                if (pvNode) R--;
+                R = std::clamp(R, 0, newDepth - 1);
+            }
 
-            rules._board.unmakeMove();
+            score = -negamax<NodeType::NonPV>(newDepth - R, -alpha - 1, -alpha);
 
-            if (stopRequest) return 0;
+            if (R > 0 && score > alpha)
+            {
+                score = -negamax<NodeType::NonPV>(newDepth, -alpha - 1, -alpha);
+            }
 
-            if (score > maxScore)
+            if (pvNode && score > alpha && score < beta)
             {
-                maxScore = score;
-                bestMove = moves[i];
+                score = -negamax<NodeType::PV>(newDepth, -beta, -alpha);
             }
+        }
+
+        board.unmakeMove();
+
+        // only the first move of a node lies on the previous PV
+        if constexpr (pvNode) followPv = false;
+
+        if (_search.stopRequest) return 0;
+
+        if (score > bestScore)
+        {
+            bestScore = score;
+            bestMove = moves[i];
+
             if (score > alpha)
             {
                 alpha = score;
+                if (pvNode && !excluded) updatePv(ply, moves[i]);
+                if (rootNode && multiPvIdx == 0) rootBestMoveNodes = nodes.load(std::memory_order_relaxed) - nodesBefore;
             }
             // pruning
             if (score >= beta)
             {
-                _TT.save(rules._board.zobristKey, depth, score, TTEntry::Type::LOWERBOUND, moves[i]);
+                if (isQuiet) updateQuietStats(moves[i], quietsTried, quietCount, depth);
+                if constexpr (Search::useCaptureHistory) updateCaptureStats(moves[i], capturesTried, captureCount, depth);
+
+                if (storeTT) _search._TT.save(board.zobristKey, depth, scoreToTT(score, ply), TTEntry::Type::LOWERBOUND, moves[i]);
                 return score;
             }
         }
 
-        TTEntry::Type type = (maxScore <= originAlpha) ? TTEntry::Type::UPPERBOUND : TTEntry::Type::EXACT;
-        _TT.save(rules._board.zobristKey, depth, maxScore, type, bestMove);
-        return maxScore;
+        if (isQuiet && quietCount < static_cast<int>(quietsTried.size())) quietsTried[quietCount++] = moves[i];
+        else if (moves[i].isAnyCapture() && captureCount < static_cast<int>(capturesTried.size())) capturesTried[captureCount++] = moves[i];
     }
-    else
+
+    // nothing left after the skips (e.g. the only move excluded) - fail low, -INF is no score
+    if (searchedMoves == 0) return alpha;
+
+    if (!storeTT) return bestScore;
+
+    TTEntry::Type type = (bestScore <= originAlpha) ? TTEntry::Type::UPPERBOUND : TTEntry::Type::EXACT;
+    _search._TT.save(board.zobristKey, depth, scoreToTT(bestScore, ply), type, bestMove);
+    return bestScore;
+}
+
+void SearchWorker::updateQuietStats(Move bestMove, const std::array<Move, 64> &quietsTried, int quietCount, int depth)
+{
+    const int ply = searchPly();
+    auto &killers = stack[ply].killers;
+    if (!sameMove(killers[0], bestMove))
     {
-        int minScore = std::numeric_limits<int>::max();
-        Move bestMove = Move{0};
-        int originBeta = beta;
+        killers[1] = killers[0];
+        killers[0] = bestMove;
+    }
+
+    // gravity: h += bonus - h * |bonus| / max, keeps values inside (-historyMax, historyMax)
+    auto &historyUs = history[std::to_underlying(board.sideToMove)];
+    const int bonus = std::min(depth * depth, 1200);
+
+    auto update = [](int &entry, int value) { entry += value - (entry * std::abs(value) / historyMax); };
 
-        for (int i = 0; i < moveCount; ++i)
+    const StackEntry *prev = previousMove(1);
+    if (prev) counterMoves[prev->movedPiece][Move{prev->currentMove}.TargetSq()] = bestMove;
+
+    std::array<PieceToHistory*, 2> conts = { continuation(1), continuation(2) };
+
+    auto updateAll = [&](Move move, int value)
+    {
+        update(historyUs[move.OriginSq()][move.TargetSq()], value);
+
+        const uint8_t piece = movedPiece(move);
+        for (PieceToHistory *cont : conts)
         {
-            rules._board.makeMove(moves[i]);
+            if (!cont) continue;
 
-            int score = minMax(rules, depth - 1, alpha, beta, true);
+            int entry = (*cont)[piece][move.TargetSq()];
+            update(entry, value);
+            (*cont)[piece][move.TargetSq()] = static_cast<int16_t>(entry);
+        }
+    };
 
-            rules._board.unmakeMove();
+    updateAll(bestMove, bonus);
 
-            if (stopRequest) return 0;
+    for (int i = 0; i < quietCount; ++i)
+    {
+        updateAll(quietsTried[i], -bonus);
+    }
+}
 
-            if (score < minScore)
-            {
-                minScore = score;
-                bestMove = moves[i];
-            }
-            if (score < beta)
+void SearchWorker::updateCaptureStats(Move bestMove, const std::array<Move, 64> &capturesTried, int captureCount, int depth)
+{
+    const int bonus = std::min(depth * depth, 1200);
+
+    auto update = [this](Move move, int value)
+    {
+        int &entry = captureHistory[movedPiece(move)][move.TargetSq()][capturedType(move)];
+        entry += value - (entry * std::abs(value) / historyMax);
+    };
+
+    if (bestMove.isAnyCapture()) update(bestMove, bonus);
+
+    for (int i = 0; i < captureCount; ++i)
+    {
+        update(capturesTried[i], -bonus);
+    }
+}
+
+[[nodiscard]] size_t SearchWorker::capturedType(Move move) const
+{
+    if (move.isEpCapture()) return 0;
+
+    return (board.getBitboard(bitBoardSet(move.TargetSq())) - Board::align) / 2;
+}
+
+[[nodiscard]] const SearchWorker::StackEntry* SearchWorker::previousMove(int pliesBack) const
+{
+    const int idx = searchPly() - pliesBack;
+    if (idx < 0 || idx >= maxPly) return nullptr;
+
+    const StackEntry &entry = stack[idx];
+    return (entry.movedPiece != 0) ? &entry : nullptr;
+}
+
+[[nodiscard]] SearchWorker::PieceToHistory* SearchWorker::continuation(int pliesBack)
+{
+    const StackEntry *entry = previousMove(pliesBack);
+    return entry ? &continuationHistory[entry->movedPiece][Move{entry->currentMove}.TargetSq()] : nullptr;
+}
+
+void SearchWorker::clearHeuristics()
+{
+    for (auto &entry : stack) entry.killers = {};
+    history = {};
+    counterMoves = {};
+    continuationHistory = {};
+    captureHistory = {};
+}
+
+void SearchWorker::setPosition(const Board &rootBoard)
+{
+    board = rootBoard;
+    rootPly = board.ply;
+    leafPly = std::min(maxPly, static_cast<int>(Board::MAXMoveHistory - rootPly)) - 1;
+    for (auto &entry : stack)
+    {
+        entry.killers = {};
+        entry.excludedMove = Move{0};
+    }
+    nodes.store(0, std::memory_order_relaxed);
+    bestMove = Move{0};
+    bestScore = 0;
+    completedDepth = 0;
+    nmpMinPly = 0;
+}
+
+[[nodiscard]] Move SearchWorker::rootMoveFromTT()
+{
+    using Entry = TranspositionTable::Entry;
+    Entry ttEntry = _search._TT.probe(board.zobristKey);
+
+    std::array<Move, 256> legalMoves;
+    int count = MoveGen::generateLegalMoves(rules, legalMoves.data());
+
+    if (ttEntry.isValid()) 
+    {
+        for (int i = 0; i < count; ++i) 
+        {
+            if (legalMoves[i].OriginSq() == ttEntry.move.OriginSq() &&
+                legalMoves[i].TargetSq() == ttEntry.move.TargetSq() &&
+                legalMoves[i].getType() == ttEntry.move.getType()) 
             {
-                beta = score;
+                return legalMoves[i];
             }
-            // pruning
-            if (score <= alpha)
+        }
+    }
+
+    if (bestMove.getPackedMove() == 0 && count > 0) return legalMoves[0];
+
+    return bestMove;
+}
+
+[[nodiscard]] Move SearchWorker::ponderMove()
+{
+    if (bestMove.getPackedMove() == 0) return Move{0};
+
+    if (prevPvLength > 1 && sameMove(prevPv[0], bestMove)) return prevPv[1];
+
+    board.makeMove(bestMove);
+
+    const TranspositionTable::Entry ttEntry = _search._TT.probe(board.zobristKey);
+
+    std::array<Move, 256> legalMoves;
+    const int count = MoveGen::generateLegalMoves(rules, legalMoves.data());
+
+    Move reply = Move{0};
+    if (ttEntry.isValid() && ttEntry.move.getPackedMove() != 0)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            if (sameMove(legalMoves[i], ttEntry.move))
             {
-                _TT.save(rules._board.zobristKey, depth, score, TTEntry::Type::UPPERBOUND, moves[i]);
-                return score;
+                reply = legalMoves[i];
+                break;
             }
         }
+    }
+
+    board.unmakeMove();
+
+    return reply;
+}
+
+void SearchWorker::updatePv(int ply, Move move)
+{
+    if (ply >= maxPly) return;
 
-        TTEntry::Type type = (minScore >= originBeta) ? TTEntry::Type::LOWERBOUND : TTEntry::Type::EXACT;
-        _TT.save(rules._board.zobristKey, depth, minScore, type, bestMove);
-        return minScore;
+    pvTable[ply][ply] = move;
+
+    const int childEnd = (ply + 1 < maxPly) ? pvLength[ply + 1] : ply + 1;
+    for (int next = ply + 1; next < childEnd; ++next)
+    {
+        pvTable[ply][next] = pvTable[ply + 1][next];
     }
+
+    pvLength[ply] = std::max(childEnd, ply + 1);
 }
 
-Move Search::searchPosition(ChessRules &rules, int maxDepth, int timeInMillis) 
+void SearchWorker::printInfo(int depth, int score, const char *bound)
 {
-    Move bestRootMove = Move{0};
+    const int64_t elapsed = _search.timeManager.elapsed();
+
+    const uint64_t totalNodes = _search.nodesSearched();
+    const uint64_t nps = (elapsed > 0) ? (totalNodes * 1000 / static_cast<uint64_t>(elapsed)) : totalNodes;
+
+    std::cout << " info depth " << depth;
+    std::cout << " seldepth " << std::max(seldepth, depth);
+    std::cout << " multipv " << (multiPvIdx + 1);
+    // mate in N moves (negative - we are mated)
+    if (score >= MATE_BOUND)       std::cout << " score mate " << (MATE_SCORE - score + 1) / 2;
+    else if (score <= -MATE_BOUND) std::cout << " score mate " << -(MATE_SCORE + score) / 2;
+    else                           std::cout << " score cp " << score;
+    if (bound != nullptr) std::cout << " " << bound;
+    std::cout << " nodes " << totalNodes;
+    std::cout << " nps " << nps;
+    std::cout << " hashfull " << _search._TT.hashfull();
+    std::cout << " time " << elapsed;
+    std::cout << " pv";
+
+    // a failed aspiration search leaves no PV - the line's previous one is shown, or at least
+    // the root move searched last; bestMove belongs to line 1 and is excluded from the others
+    const PvLine &line = pvLines[multiPvIdx];
+
+    if (pvLength[0] > 0)
+    {
+        for (int i = 0; i < pvLength[0]; ++i) std::cout << " " << moveToUci(pvTable[0][i]);
+    }
+    else if (line.length > 0)
+    {
+        for (int i = 0; i < line.length; ++i) std::cout << " " << moveToUci(line.pv[i]);
+    }
+    else if (stack[0].currentMove.getPackedMove() != 0)
+    {
+        std::cout << " " << moveToUci(stack[0].currentMove);
+    }
 
-    stopRequest = false;
-    nodes = 0;
-    startTime = std::chrono::steady_clock::now();
-    allocatedTime = timeInMillis;
+    std::cout << std::endl;
+}
 
-    bool isMaxTurn = (rules._board.sideToMove == pColor::White);
+[[nodiscard]] bool SearchWorker::isLineTaken(Move move) const
+{
+    for (int line = 0; line < multiPvIdx; ++line)
+    {
+        if (sameMove(pvLines[line].pv[0], move)) return true;
+    }
+    return false;
+}
 
-    for (int depth = 1; depth <= maxDepth; ++depth) 
+[[nodiscard]] int SearchWorker::aspirationSearch(int depth, int searchDepth, int previousScore)
+{
+    // aspiration window around the previous iteration score
+    int delta = Search::aspirationWindow;
+    int alpha = -INF;
+    int beta = INF;
+
+    if (searchDepth >= Search::aspirationMinDepth)
     {
-        int score = minMax(rules, depth, -INF, INF, isMaxTurn);
-        
-        if (stopRequest)
+        alpha = std::max(previousScore - delta, -INF);
+        beta = std::min(previousScore + delta, INF);
+    }
+
+    while (true)
+    {
+        followPv = (prevPvLength > 0);
+        const int score = negamax<NodeType::Root>(searchDepth, alpha, beta);
+
+        if (_search.stopRequest) return score;
+
+        if (score <= alpha)
         {
-            break;
+            if (isMainThread()) printInfo(depth, score, "upperbound");
+
+            beta = (alpha + beta) / 2;
+            alpha = std::max(score - delta, -INF);
         }
+        else if (score >= beta)
+        {
+            if (isMainThread()) printInfo(depth, score, "lowerbound");
 
-        using Entry = TranspositionTable::Entry;
-        Entry ttEntry = _TT.probe(rules._board.zobristKey);
+            beta = std::min(score + delta, INF);
+        }
+        else
+        {
+            return score;
+        }
+
+        delta += delta / 2;
 
-        if (ttEntry.isValid()) 
+        if (delta > Search::aspirationMaxWindow)
         {
-            std::array<Move, 256> legalMoves;
-            int count = MoveGen::generateLegalMoves(rules, legalMoves.data());
-            
-            bool isLegal = false;
-            for(int i=0; i<count; ++i) 
+            alpha = -INF;
+            beta = INF;
+        }
+    }
+}
+
+void SearchWorker::iterativeDeepening(int maxDepth)
+{
+    // helpers only feed the TT and search the best line
+    int multiPv = 1;
+    if (isMainThread())
+    {
+        std::array<Move, 256> legalMoves;
+        multiPv = std::clamp(MoveGen::generateLegalMoves(rules, legalMoves.data()), 1, _search.multiPv());
+    }
+
+    pvLines.assign(static_cast<size_t>(multiPv), PvLine{});
+    multiPvIdx = 0;
+
+    for (int depth = 1; depth <= maxDepth; ++depth) 
+    {
+        // never past maxDepth - with "go depth N" a helper's deeper move could be played unreported
+        const int searchDepth = isMainThread() ? depth : std::min(depth + static_cast<int>(id & 1), maxDepth);
+        rootDepth = searchDepth;
+        seldepth = 0;
+        rootBestMoveNodes = 0;
+
+        const uint64_t iterationStartNodes = nodes.load(std::memory_order_relaxed);
+        const Move previousBestMove = bestMove;
+        const int previousScore = bestScore;
+
+        int score = 0;
+
+        // one line after another, every next one without the root moves of the lines above it
+        for (multiPvIdx = 0; multiPvIdx < multiPv; ++multiPvIdx)
+        {
+            PvLine &line = pvLines[multiPvIdx];
+
+            // the line's PV of the previous iteration is searched first
+            prevPvLength = line.length;
+            std::copy_n(line.pv.begin(), prevPvLength, prevPv.begin());
+
+            const int lineScore = aspirationSearch(depth, searchDepth, line.score);
+
+            if (_search.stopRequest) break;
+
+            if (pvLength[0] > 0)
+            {
+                line.length = pvLength[0];
+                std::copy_n(pvTable[0].begin(), line.length, line.pv.begin());
+            }
+            else if (multiPvIdx == 0)
             {
-                if (legalMoves[i].OriginSq() == ttEntry.move.OriginSq() &&
-                    legalMoves[i].TargetSq() == ttEntry.move.TargetSq()) 
-                {
-                    bestRootMove = legalMoves[i]; 
-                    isLegal = true;
-                    break;
-                }
+                line.pv[0] = rootMoveFromTT();
+                line.length = 1;
             }
+            line.score = lineScore;
 
-            if (!isLegal && bestRootMove.getPackedMove() == 0 && count > 0) 
+            if (multiPvIdx == 0)
             {
-                bestRootMove = legalMoves[0];
+                bestMove = line.pv[0];
+                bestScore = lineScore;
+                completedDepth = searchDepth;
+                score = lineScore;
+
+                // ponder move source
+                prevPvLength = line.length;
+                std::copy_n(line.pv.begin(), prevPvLength, prevPv.begin());
             }
+
+            if (isMainThread()) printInfo(depth, lineScore, nullptr);
+        }
+
+        multiPvIdx = 0;
+
+        if (_search.stopRequest)
+        {
+            break;
         }
 
-        std::string moveStr = SimpleParser::moveToString(bestRootMove.OriginSq(), bestRootMove.TargetSq());
-        std::cout << " info depth " << depth;
-        std::cout << " score cp " << ttEntry.score;
-        std::cout << " nodes " << nodes;
-        std::cout << " pv " << moveStr << std::endl;
+        if (!isMainThread()) continue;
+
+        // the mate is well inside the horizon - deeper iterations only confirm it
+        if (std::abs(score) >= MATE_BOUND && (MATE_SCORE - std::abs(score)) + Search::mateStopMargin <= searchDepth)
+        {
+            break;
+        }
+
+        const bool bestMoveChanged = !sameMove(bestMove, previousBestMove);
+        const uint64_t iterationNodes = nodes.load(std::memory_order_relaxed) - iterationStartNodes;
+
+        if (!_search.ponder && _search.timeManager.stopAfterIteration(depth, bestMoveChanged, previousScore - score, rootBestMoveNodes, iterationNodes))
+        {
+            break;
+        }
     }
+}
 
-    std::string moveStr = SimpleParser::moveToString(bestRootMove.OriginSq(), bestRootMove.TargetSq());
-    if (char promChar = SimpleParser::promotionTypeToChar(bestRootMove.getType()); 
-        promChar != '\0')
-    { 
-        moveStr += promChar;
+void Search::setThreads(int count)
+{
+    count = std::clamp(count, 1, maxThreads);
+
+    workers.clear();
+    for (int i = 0; i < count; ++i)
+    {
+        workers.push_back(std::make_unique<SearchWorker>(*this, static_cast<size_t>(i)));
     }
-    std::cout << "bestmove " << moveStr << std::endl;
+}
+
+[[nodiscard]] uint64_t Search::nodesSearched() const
+{
+    uint64_t sum = 0;
+    for (const auto &worker : workers)
+    {
+        sum += worker->nodes.load(std::memory_order_relaxed);
+    }
+    return sum;
+}
+
+Move Search::searchPosition(ChessRules &rules, int maxDepth, const TimeLimits &limits) 
+{
+    stopRequest = false;
+    timeManager.init(limits);
+    timeManager.start(stopRequest, ponder);
+
+    for (auto &worker : workers)
+    {
+        worker->setPosition(rules._board);
+    }
+
+    // Lazy SMP - helpers search the same root and share only the TT
+    std::vector<std::thread> helpers;
+    for (size_t i = 1; i < workers.size(); ++i)
+    {
+        helpers.emplace_back([this, i, maxDepth]() { workers[i]->iterativeDeepening(maxDepth); });
+    }
+
+    workers[0]->iterativeDeepening(maxDepth);
+
+    // UCI - no "bestmove" while pondering, even when the search is done
+    mainFinished = true;
+    while (ponder && !stopRequest) stopRequest.wait(false);
+
+    stopRequest = true;
+    ponder = false;
+    mainFinished = false;
+    timeManager.stop();
+    for (auto &helper : helpers) helper.join();
+
+    // the deepest completed iteration wins, main thread on ties
+    SearchWorker *best = workers[0].get();
+    for (const auto &worker : workers)
+    {
+        if (worker->completedDepth > best->completedDepth && worker->bestMove.getPackedMove() != 0)
+        {
+            best = worker.get();
+        }
+    }
+
+    Move bestRootMove = best->bestMove;
+    if (bestRootMove.getPackedMove() == 0)
+    {
+        std::array<Move, 256> legalMoves;
+        if (MoveGen::generateLegalMoves(rules, legalMoves.data()) > 0) bestRootMove = legalMoves[0];
+    }
+
+    const Move reply = sameMove(bestRootMove, best->bestMove) ? best->ponderMove() : Move{0};
+
+    std::cout << "bestmove " << moveToUci(bestRootMove);
+    if (reply.getPackedMove() != 0) std::cout << " ponder " << moveToUci(reply);
+    std::cout << std::endl;
+
+    searching = false;
 
     return bestRootMove;
 }
 
+void Search::stop()
+{
+    stopRequest = true;
+    stopRequest.notify_all();
+}
+
+void Search::ponderhit()
+{
+    if (!ponder.exchange(false)) return;
+
+    timeManager.ponderhit(stopRequest);
+
+    // the main thread has already finished and only waits for this
+    if (mainFinished) stop();
+}
+
 void Search::SearchDivideMinimax(int depth, ChessRules &rules) 
+{
+    stopRequest = false;
+    timeManager.init(TimeLimits{});
+    timeManager.start(stopRequest);
+
+    workers[0]->setPosition(rules._board);
+    workers[0]->divide(depth);
+}
+
+void SearchWorker::divide(int depth) 
 {
     std::array<Move, 256> moves;
     int moveCount = MoveGen::generateLegalMoves(rules, moves.data());
@@ -329,41 +1070,31 @@ void Search::SearchDivideMinimax(int depth, ChessRules &rules)
     std::cout << "Move | Score \n";
     std::cout << "-----|-------\n";
 
-    bool amIWhite = (rules._board.sideToMove == pColor::White);
-    
-    int bestScore = amIWhite ? -INF : INF;
+    int bestScore = -INF;
     Move bestMove;
     bool foundAny = false;
 
     for (int i = 0; i < moveCount; ++i) 
     {
-        rules._board.makeMove(moves[i]);
+        board.makeMove(moves[i]);
 
-       int score = minMax(rules, depth - 1, -INF, INF, !amIWhite);
+        int score = -negamax<NodeType::PV>(depth - 1, -INF, INF);
 
-        rules._board.unmakeMove();
+        board.unmakeMove();
 
         std::string moveStr = SimpleParser::moveToString(moves[i].OriginSq(), moves[i].TargetSq());
         
         std::string scoreStr;
-        if (score > 29000) scoreStr = "+Mate";
-        else if (score < -29000) scoreStr = "-Mate";
+        if (score >= MATE_BOUND) scoreStr = "+Mate";
+        else if (score <= -MATE_BOUND) scoreStr = "-Mate";
         else scoreStr = std::to_string(score);
 
         std::cout << std::left << std::setw(5) << moveStr << "| " << scoreStr << "\n";
 
-        if (amIWhite) {
-            if (score > bestScore) {
-                bestScore = score;
-                bestMove = moves[i];
-                foundAny = true;
-            }
-        } else {
-            if (score < bestScore) {
-                bestScore = score;
-                bestMove = moves[i];
-                foundAny = true;
-            }
+        if (score > bestScore) {
+            bestScore = score;
+            bestMove = moves[i];
+            foundAny = true;
         }
     }
 
@@ -373,19 +1104,3 @@ void Search::SearchDivideMinimax(int depth, ChessRules &rules)
                   << " (Score: " << bestScore << ")\n";
     }
 }
-
-void Search::checkTime() 
-{
-    if (stopRequest) return;
-
-    if (allocatedTime > 0)
-    {
-        auto now = std::chrono::steady_clock::now();
-        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - startTime).count();
-        
-        if (elapsed >= allocatedTime) 
-        {
-            stopRequest = true;
-        }
-    }
-}
@@ -8,47 +8,351 @@
 #ifndef SEARCH_H
 #define SEARCH_H
 
+#include "Board.hpp"
 #include "MoveGeneration/ChessRules.hpp"
 #include "TranspositionTable.h"
+#include "TimeManager.h"
 #include "MoveGeneration/Move.hpp"
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <chrono>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+
+class Search;
+
+/*
+* One search thread of the Lazy SMP.
+* Every worker owns its copy of the root position, so all of them
+* can search the same root at once. The only shared state is kept
+* in the Search (transposition table, stop flag, time manager).
+*/
+class SearchWorker
+{
+public:
+    Board board;
+    ChessRules rules;
+
+    const size_t id;
+
+    // written only by the owner thread, read by the main thread for reports
+    std::atomic<uint64_t> nodes = 0;
+
+    Move bestMove = Move{0};
+    int bestScore = 0;
+    int completedDepth = 0;
+
+    // search plies below the root - the stack / PV tables size
+    static constexpr int maxPly = 128;
+
+    // ---------------------
+    // Initizaliztion
+    // ---------------------
+
+    SearchWorker(Search &search, size_t workerId)
+        : rules{board}, id{workerId}, _search{search} {}
+
+    SearchWorker(const SearchWorker&) = delete;
+    SearchWorker& operator=(const SearchWorker&) = delete;
+
+    // ---------------------
+    // Methods
+    // ---------------------
+
+    void setPosition(const Board &rootBoard);
+
+    // helpers (odd id) search one ply deeper than the main thread on every iteration (up to maxDepth)
+    void iterativeDeepening(int maxDepth);
+
+    void divide(int depth);
+
+    // ucinewgame - forget killers and history
+    void clearHeuristics();
+
+    [[nodiscard]] bool isMainThread() const { return id == 0; }
+
+    // expected reply to bestMove - second PV move, or the hash move after bestMove; Move{0} when unknown
+    [[nodiscard]] Move ponderMove();
+
+private:
+    Search &_search;
+
+    // null move verification - null moves are disabled for nmpColor until board.ply reaches nmpMinPly
+    int nmpMinPly = 0;
+    pColor nmpColor = pColor::White;
+
+    [[nodiscard]] bool nullMoveAllowed() const { return static_cast<int>(board.ply) >= nmpMinPly || board.sideToMove != nmpColor; }
+
+    // ----- Quiet move ordering (per thread) -----
+
+    static constexpr int historyMax = 16384;
+
+    size_t rootPly = 0;
+
+    // nodes at this search ply are leaves - below maxPly and below the end of the Board history
+    // (indexed by the game ply, so a long game leaves less room for the search)
+    int leafPly = maxPly - 1;
+    int rootDepth = 0;      // depth of the current iteration
+    int seldepth = 0;       // the deepest ply reached in the current iteration
+
+    std::array<std::array<std::array<int, 64>, 64>, 2> history{};   // [color][from][to]
+
+    using PieceToHistory = std::array<std::array<int16_t, 64>, Board::bitboardCount>;   // [piece][to]
+
+    // ----- Search stack -----
+
+    struct ScoredMove
+    {
+        Move move;
+        int score;
+    };
+
+    // one record per ply, preallocated with the worker - negamax / quiescence frames
+    // keep their move lists here instead of on the call stack
+    struct alignas(64) StackEntry
+    {
+        std::array<Move, 256> moves;
+        std::array<ScoredMove, 256> scoredMoves;    // orderMoves scratch
+        std::array<Move, 64> quietsTried;
+        std::array<Move, 64> capturesTried;
+
+        std::array<Move, 2> killers{};
+        Move currentMove = Move{0};     // move made from this ply, Move{0} - none / null move
+        Move excludedMove = Move{0};    // singular extension search without this move
+        uint8_t movedPiece = 0;         // PieceDescriptor idx of currentMove, 0 - none / null move
+        int staticEval = 0;
+        bool evalReady = false;         // set for a re-search of the same position at this ply (exclusion,
+                                        // null move verification, IID, razoring) - staticEval is reused
+    };
+
+    // ply < maxPly is kept by the search - the deepest frames return the static eval
+    std::array<StackEntry, maxPly> stack;
+
+    // [previous piece][previous to] -> move which refuted it
+    alignas(64) std::array<std::array<Move, 64>, Board::bitboardCount> counterMoves{};
+
+    // [previous piece][previous to][piece][to] - shared by 1 and 2 plies back
+    alignas(64) std::array<std::array<PieceToHistory, 64>, Board::bitboardCount> continuationHistory{};
+
+    // [moving piece][to][captured piece type: Pawn..King]
+    alignas(64) std::array<std::array<std::array<int, 6>, 64>, Board::bitboardCount> captureHistory{};
+
+    // ----- Principal variation -----
+
+    // triangular PV table: pvTable[ply] holds the line from ply on, pvLength[ply] - its end (as ply)
+    std::array<std::array<Move, maxPly>, maxPly> pvTable{};
+    std::array<int, maxPly> pvLength{};
+
+    // PV of the last completed iteration - searched first along the whole line in the next one
+    std::array<Move, maxPly> prevPv{};
+    int prevPvLength = 0;
+    bool followPv = false;
+
+    // nodes spent below the current best root move in this iteration (time management)
+    uint64_t rootBestMoveNodes = 0;
+
+    // ----- MultiPV -----
+
+    // the best line of the last search with its root move excluded from the next lines
+    struct PvLine
+    {
+        std::array<Move, maxPly> pv{};
+        int length = 0;
+        int score = 0;
+    };
+
+    std::vector<PvLine> pvLines;
+    int multiPvIdx = 0;         // line being searched, its root moves exclude pvLines[0 .. multiPvIdx)
+
+    [[nodiscard]] bool isLineTaken(Move move) const;
+
+    // one root search of the current line with aspiration windows, returns the exact score (unless stopped)
+    [[nodiscard]] int aspirationSearch(int depth, int searchDepth, int previousScore);
+
+    void updatePv(int ply, Move move);
+
+    [[nodiscard]] int searchPly() const { return static_cast<int>(board.ply - rootPly); }
+
+    [[nodiscard]] uint8_t movedPiece(Move move) const { return static_cast<uint8_t>(board.getBitboard(bitBoardSet(move.OriginSq()))); }
+
+    // stack entry of the move made pliesBack plies ago, nullptr when unknown or a null move
+    [[nodiscard]] const StackEntry* previousMove(int pliesBack) const;
+
+    [[nodiscard]] PieceToHistory* continuation(int pliesBack);
+
+    [[nodiscard]] size_t capturedType(Move move) const;
+
+    // beta cutoff by a quiet move: killers, countermove + history bonus, malus for the quiets tried before it
+    void updateQuietStats(Move bestMove, const std::array<Move, 64> &quietsTried, int quietCount, int depth);
+
+    // any beta cutoff: bonus for the cutoff move when it is a capture, malus for the captures tried before it
+    void updateCaptureStats(Move bestMove, const std::array<Move, 64> &capturesTried, int captureCount, int depth);
+
+    void countNode() { nodes.store(nodes.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed); }
+
+    void orderMoves(std::array<Move, 256> &moves, int count, Move hashMove, Move pvMove = Move{0});
+
+    // side to move relative
+    [[nodiscard]] int staticEval();
+
+    // Root - the iteration root, PV - full window (first moves of PV nodes and their re-searches),
+    // NonPV - null window, RootExclusion - null window singular search of the root (root moves);
+    // every variant is compiled separately without the code it doesn't need
+    enum class NodeType { Root, PV, NonPV, RootExclusion };
+
+    // negamax, fail-soft - scores are relative to the side to move
+    [[nodiscard]] int quiescence(int alpha, int beta);
+
+    // stack[ply].excludedMove set - singular extension search without this move (no TT cutoffs / writes)
+    template<NodeType NT>
+    [[nodiscard]] int negamax(int depth, int alpha, int beta);
+
+    [[nodiscard]] Move rootMoveFromTT();
+
+    // bound - "lowerbound" / "upperbound" for aspiration fails, nullptr for the exact score
+    void printInfo(int depth, int score, const char *bound);
+};
 
 class Search
 {
 private:
-    std::chrono::steady_clock::time_point startTime;
-    int allocatedTime;
-    uint64_t nodes;         // nodes counter
+    friend class SearchWorker;
+
+    // the timer thread sets stopRequest at the hard limit, the main thread checks the soft one
+    TimeManager timeManager;
 
-    void orderMoves(std::array<Move, 256> &moves, int count, Move hashMove, ChessRules& rules);
+    // workers[0] is the main thread - it decides when to stop and reports
+    std::vector<std::unique_ptr<SearchWorker>> workers;
 
-    [[nodiscard]] int quiescence(ChessRules &rules, int alpha, int beta, bool isMaxTurn);
+    // the main thread is done with the iterations (set while it may wait for ponderhit)
+    std::atomic<bool> mainFinished = false;
 
-    [[nodiscard]] int minMax(ChessRules &rules, int depth, int alpha, int beta, bool isMaxTurn);
+    int _multiPv = 1;
 
-    void checkTime();
+    [[nodiscard]] uint64_t nodesSearched() const;
 
 public:
+    static constexpr int maxThreads = 256;
+    static constexpr int maxMultiPv = 256;
+
+    // game plies a root position can have - the full search depth still fits in the Board history
+    static constexpr size_t maxRootPly = Board::MAXMoveHistory - SearchWorker::maxPly;
+
+    // aspiration windows: starting half-width (cp), widened by 50% on every fail,
+    // full window after aspirationMaxWindow
+    static constexpr int aspirationWindow    = 25;
+    static constexpr int aspirationMaxWindow = 500;
+    static constexpr int aspirationMinDepth  = 4;
+
+    // null move pruning: R = nmpBaseReduction + depth / nmpDepthDivisor,
+    // verified by a reduced search from nmpVerificationDepth
+    static constexpr int nmpMinDepth          = 3;
+    static constexpr int nmpBaseReduction     = 3;
+    static constexpr int nmpDepthDivisor      = 6;
+    static constexpr int nmpVerificationDepth = 12;
+
+    // shallow depth pruning margins (cp), indexed by the remaining depth where it is an array
+    static constexpr int rfpMaxDepth = 6;
+    static constexpr int rfpMargin   = 90;     // * depth
+
+    static constexpr int futilityMaxDepth = 3;
+    static constexpr std::array<int, futilityMaxDepth + 1> futilityMargins = { 0, 200, 300, 500 };
+
+    static constexpr int razorMaxDepth = 2;
+    static constexpr std::array<int, razorMaxDepth + 1> razorMargins = { 0, 300, 550 };
+
+    // singular extension: TT move is singular when the others fail low against ttScore - singularMargin * depth
+    static constexpr int singularMinDepth = 8;
+    static constexpr int singularMargin   = 2;
+
+    // no hash move: internal iterative reduction (depth - 1) from iirMinDepth,
+    // or with useIID the classic internal iterative deepening in PV nodes (depth - iidReduction search first)
+    static constexpr bool useIID      = false;
+    static constexpr int iirMinDepth  = 4;
+    static constexpr int iidMinDepth  = 5;
+    static constexpr int iidReduction = 2;
+
+    // captures ordered by MVV-LVA, with useCaptureHistory + captureHistory / captureHistoryDivisor
+    // (off - no tried setting saved nodes on the bench positions at every depth)
+    static constexpr bool useCaptureHistory    = false;
+    static constexpr int captureHistoryDivisor = 16;
+
+    // iterative deepening stops once a mate in N plies was found at depth >= N + mateStopMargin
+    static constexpr int mateStopMargin = 4;
+
+    // quiescence delta pruning: stand pat + captured piece + deltaMargin <= alpha
+    static constexpr int deltaMargin = 200;
+
+    // late move reductions: [depth][move index] -> plies, 0.75 + ln(depth) * ln(move index) / 2.25
+    static constexpr int lmrMinDepth     = 3;
+    static constexpr int lmrMinMoveIndex = 3;
+
+    inline static const std::array<std::array<int, 64>, 64> lmrReductions = [] () {
+        std::array<std::array<int, 64>, 64> table{};
+
+        for (int depth = 1; depth < 64; ++depth)
+        {
+            for (int moveIdx = 1; moveIdx < 64; ++moveIdx)
+            {
+                table[depth][moveIdx] = static_cast<int>(0.75 + std::log(depth) * std::log(moveIdx) / 2.25);
+            }
+        }
+
+        return table;
+    }();
+
     TranspositionTable &_TT;
 
     std::atomic<bool> stopRequest = false;
 
+    // "go ponder" - no time limits and no "bestmove" until ponderhit or stop
+    std::atomic<bool> ponder = false;
+
+    // set by UCI before the search thread starts, cleared once "bestmove" is sent
+    std::atomic<bool> searching = false;
+
     // ---------------------
     // Initizaliztion
     // ---------------------
 
     explicit Search(TranspositionTable &TT)
-        : _TT{TT} {}
+        : _TT{TT} 
+    { 
+        setThreads(1); 
+    }
 
     // ---------------------
     // Methods
     // ---------------------
 
-    Move searchPosition(ChessRules &rules, int maxDepth, int timeInMillis);
+    // clamped to [1, maxThreads]
+    void setThreads(int count);
+
+    [[nodiscard]] int threads() const { return static_cast<int>(workers.size()); }
+
+    // number of best lines reported, clamped to [1, maxMultiPv] (and to the legal moves count on search)
+    void setMultiPv(int count) { _multiPv = std::clamp(count, 1, maxMultiPv); }
+
+    [[nodiscard]] int multiPv() const { return _multiPv; }
+
+    // blocks until every thread has finished, the result is printed as "bestmove"
+    Move searchPosition(ChessRules &rules, int maxDepth, const TimeLimits &limits);
+
+    // "stop" - also ends a finished ponder search waiting for ponderhit
+    void stop();
+
+    // the expected move was played - the search goes on under the time limits
+    void ponderhit();
 
-    void clear() { _TT.clear(); }
+    void clear() 
+    { 
+        _TT.clear(); 
+        for (auto &worker : workers) worker->clearHeuristics();
+    }
 
     void SearchDivideMinimax(int depth, ChessRules &rules);
 };
@@ -0,0 +1,135 @@
+// Copyright (c) 2025 Bartlomiej Kozka
+// All rights reserved.
+
+/*************** File description ****************/
+// Time allocation of a single search
+/*************************************************/
+
+#include "TimeManager.h"
+
+#include <algorithm>
+
+
+void TimeManager::init(const TimeLimits &limits)
+{
+    stop();
+
+    _optimum = 0;
+    _maximum = 0;
+    _fixedTime = false;
+    _stableIterations = 0;
+
+    if (limits.moveTime > 0)
+    {
+        _fixedTime = true;
+        _optimum = std::max<int64_t>(limits.moveTime - limits.moveOverhead, minTime);
+        _maximum = _optimum;
+    }
+    else if (limits.time > 0 || limits.inc > 0)
+    {
+        const int64_t available = std::max<int64_t>(limits.time - limits.moveOverhead, minTime);
+        const int64_t movesToGo = (limits.movesToGo > 0) ? std::min(limits.movesToGo, maxMovesToGo) : defaultMovesToGo;
+        const int64_t cap = std::max<int64_t>(available * maxTimeShare / 100, minTime);
+
+        _optimum = std::clamp<int64_t>(available / movesToGo + (limits.inc * 3 / 4), minTime, cap);
+        _maximum = std::clamp<int64_t>(_optimum * maxScale, _optimum, cap);
+    }
+}
+
+void TimeManager::start(std::atomic<bool> &stopFlag, bool ponder)
+{
+    std::lock_guard control(_controlMutex);
+
+    cancelTimer();
+
+    _startTime = Clock::now();
+    _armed = false;
+
+    if (!ponder) arm(stopFlag);
+}
+
+void TimeManager::ponderhit(std::atomic<bool> &stopFlag)
+{
+    std::lock_guard control(_controlMutex);
+
+    cancelTimer();
+    arm(stopFlag);
+}
+
+void TimeManager::stop()
+{
+    std::lock_guard control(_controlMutex);
+
+    cancelTimer();
+}
+
+void TimeManager::arm(std::atomic<bool> &stopFlag)
+{
+    const auto now = Clock::now();
+
+    _clockStart = now.time_since_epoch().count();
+    _armed = true;
+
+    if (!isLimited()) return;
+
+    {
+        std::lock_guard lock(_mutex);
+        _cancelled = false;
+    }
+
+    const auto deadline = now + std::chrono::milliseconds(_maximum);
+
+    _timer = std::thread([this, &stopFlag, deadline]() {
+        std::unique_lock lock(_mutex);
+        if (!_cv.wait_until(lock, deadline, [this]() { return _cancelled; }))
+        {
+            stopFlag = true;
+        }
+    });
+}
+
+void TimeManager::cancelTimer()
+{
+    {
+        std::lock_guard lock(_mutex);
+        _cancelled = true;
+    }
+    _cv.notify_all();
+
+    if (_timer.joinable()) _timer.join();
+}
+
+[[nodiscard]] int64_t TimeManager::elapsed() const
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - _startTime).count();
+}
+
+[[nodiscard]] int64_t TimeManager::clockElapsed() const
+{
+    const Clock::time_point clockStart{Clock::duration{_clockStart.load()}};
+    return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - clockStart).count();
+}
+
+[[nodiscard]] int64_t TimeManager::softLimit(int scoreDrop, uint64_t bestMoveNodes, uint64_t iterationNodes) const
+{
+    if (_fixedTime) return _optimum;
+
+    const int64_t stability = stabilityScales[std::min<size_t>(_stableIterations, stabilityScales.size() - 1)];
+    const int64_t drop = 100 + (std::clamp(scoreDrop, 0, maxScoreDrop) * scoreDropScale);
+
+    int64_t nodeShare = 50;
+    if (iterationNodes > 0) nodeShare = static_cast<int64_t>(std::min(bestMoveNodes, iterationNodes) * 100 / iterationNodes);
+    const int64_t nodes = nodeScaleBase - nodeShare;
+
+    return std::min(_optimum * stability * drop * nodes / (100 * 100 * 100), _maximum);
+}
+
+[[nodiscard]] bool TimeManager::stopAfterIteration(int depth, bool bestMoveChanged, int scoreDrop,
+                                                   uint64_t bestMoveNodes, uint64_t iterationNodes)
+{
+    _stableIterations = bestMoveChanged ? 0 : _stableIterations + 1;
+
+    if (!isLimited() || !_armed || depth < minDepth) return false;
+
+    return clockElapsed() >= softLimit(scoreDrop, bestMoveNodes, iterationNodes);
+}
@@ -0,0 +1,137 @@
+// Copyright (c) 2025 Bartlomiej Kozka
+// All rights reserved.
+
+/*************** File description ****************/
+// Time allocation of a single search
+/*************************************************/
+// Two limits are computed from the clock:
+//  - optimum (soft) - checked after every iteration of the main thread,
+//    scaled by the best move stability, score drop and the share of
+//    root nodes spent on the best move
+//  - maximum (hard) - enforced by a timer thread which sets the stop flag,
+//    so the search doesn't have to poll the clock
+// While pondering the clock isn't running - both limits count from ponderhit.
+
+#ifndef TIME_MANAGER_H
+#define TIME_MANAGER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+
+// "go" time parameters of the side to move, -1 / 0 - not given
+struct TimeLimits
+{
+    int time = 0;
+    int inc = 0;
+    int movesToGo = -1;
+    int moveTime = -1;
+    int moveOverhead = 0;
+};
+
+class TimeManager
+{
+public:
+    // clock: optimum = time / movesToGo + 3/4 of the increment, maximum = optimum * maxScale,
+    // both kept below maxTimeShare % of the remaining time
+    static constexpr int defaultMovesToGo = 30;
+    static constexpr int maxMovesToGo     = 50;
+    static constexpr int maxScale         = 4;
+    static constexpr int maxTimeShare     = 80;
+    static constexpr int minTime          = 10;
+
+    // soft limit scales (%): [iterations with the same best move], capped at the last one
+    static constexpr std::array<int, 5> stabilityScales = { 140, 115, 100, 85, 70 };
+
+    // score drop (cp) against the previous iteration adds scoreDropScale % per cp, up to maxScoreDrop
+    static constexpr int scoreDropScale = 1;
+    static constexpr int maxScoreDrop   = 60;
+
+    // best move node share: scale = nodeScaleBase - share, so 90% share -> 60%, 50% share -> 100%
+    static constexpr int nodeScaleBase = 150;
+
+    // soft checks start from this depth, earlier iterations are too noisy
+    static constexpr int minDepth = 4;
+
+    // ---------------------
+    // Initizaliztion
+    // ---------------------
+
+    TimeManager() = default;
+    ~TimeManager() { stop(); }
+
+    TimeManager(const TimeManager&) = delete;
+    TimeManager& operator=(const TimeManager&) = delete;
+
+    // ---------------------
+    // Methods
+    // ---------------------
+
+    // computes the limits, no time given - unlimited (depth / "stop" ends the search)
+    void init(const TimeLimits &limits);
+
+    // starts the clock and, when limited, the timer thread which sets stopFlag at the hard limit
+    // ponder - the limits are not applied until ponderhit
+    void start(std::atomic<bool> &stopFlag, bool ponder = false);
+
+    // the expected move was played - the limits count from now on
+    void ponderhit(std::atomic<bool> &stopFlag);
+
+    // cancels and joins the timer thread
+    void stop();
+
+    [[nodiscard]] bool isLimited() const { return _optimum > 0; }
+
+    [[nodiscard]] int64_t optimum() const { return _optimum; }
+
+    [[nodiscard]] int64_t maximum() const { return _maximum; }
+
+    // since start, for reports
+    [[nodiscard]] int64_t elapsed() const;
+
+    // since the limits were applied (start, or ponderhit when pondering)
+    [[nodiscard]] int64_t clockElapsed() const;
+
+    // called after every completed iteration of the main thread
+    // bestMoveNodes / iterationNodes - share of the iteration spent below the best root move
+    [[nodiscard]] bool stopAfterIteration(int depth, bool bestMoveChanged, int scoreDrop,
+                                          uint64_t bestMoveNodes, uint64_t iterationNodes);
+
+    // optimum scaled by the best move stability, score drop and node share (not above the maximum)
+    [[nodiscard]] int64_t softLimit(int scoreDrop, uint64_t bestMoveNodes, uint64_t iterationNodes) const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    Clock::time_point _startTime;
+
+    // set by the UCI thread on ponderhit, read by the main search thread
+    std::atomic<Clock::rep> _clockStart = 0;
+    std::atomic<bool> _armed = false;
+
+    int64_t _optimum = 0;
+    int64_t _maximum = 0;
+
+    // fixed "movetime" - soft limit isn't scaled, the whole time is used
+    bool _fixedTime = false;
+
+    // iterations in a row with the same best move
+    int _stableIterations = 0;
+
+    std::thread _timer;
+    std::mutex _controlMutex;   // start / ponderhit / stop may come from different threads
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    bool _cancelled = false;
+
+    void arm(std::atomic<bool> &stopFlag);
+
+    void cancelTimer();
+};
+
+#endif // TIME_MANAGER_H
@@ -2,20 +2,25 @@
 // All rights reserved.
 
 /*************** File description ****************/
-// Main search engine
+// Transposition table shared by the search threads
 /*************************************************/
 
 #ifndef TRANSPOSITION_TABLE_H
 #define TRANSPOSITION_TABLE_H
 
 #include "MoveGeneration/Move.hpp"
+#include "Shared/XorTable.h"
 
-#include <vector>
+#include <algorithm>
 #include <cstdint>
 #include <iostream>
-#include <algorithm>
 
 
+/*
+* Shared by all search threads (Lazy SMP) without locks (see Shared/XorTable.h).
+*
+* data packing: bits 0-15 move, 16-47 score, 48-55 depth, 56-57 type
+*/
 class TranspositionTable 
 {
 public:
@@ -52,61 +57,56 @@ public:
     // !!! Have to be called after/in TT contructor to init size of TT
     void resize(int sizeInMB)
     {
-        size_t entrySize = sizeof(Entry);        
-        size_t count = (sizeInMB * 1024 * 1024) / entrySize;    // 64MB ~ 1 milion idx's
-
-        size_t powerOf2 = 1;
-        while (powerOf2 * 2 <= count) {
-            powerOf2 *= 2;
-        }
-
-        table.resize(powerOf2);
-        table.shrink_to_fit();
-        
-        // 5. Maska do indeksowania (zamiast modulo)
-        // Np. dla rozmiaru 4096 (binarnie 1000000000000)
-        // maska to 4095 (binarnie 0111111111111)
-        mask = powerOf2 - 1;
+        const size_t count = table.resize(sizeInMB);
 
-        std::cout << "TT initialized with " << powerOf2 << " entries (" 
-                  << (powerOf2 * entrySize) / (1024*1024) << " MB)" << std::endl;
-        
-        clear();
+        std::cout << "TT initialized with " << count << " entries (" 
+                  << (count * sizeof(XorSlot)) / (1024*1024) << " MB)" << std::endl;
     }
 
     void clear() 
     {
-        std::fill(table.begin(), table.end(), Entry{});
+        table.clear();
     }
 
     void save(uint64_t key, int depth, int score, Entry::Type type, Move move)
     {
-        size_t index = key & mask;
+        XorSlot &slot = table.bucket(key);
 
-        Entry& entry = table[index];
+        const Entry entry = unpack(slot);
 
-        bool replace = (entry.key == 0) || 
+        bool replace = (!entry.isValid()) || 
                        (entry.depth <= depth); 
 
         if (replace) 
         {
-            if (static_cast<uint16_t>(move.getPackedMove()) == 0)
+            if (static_cast<uint16_t>(move.getPackedMove()) == 0 && entry.key == key)
             {
                 move = entry.move;
             }
 
-            entry.key = key;
-            entry.depth = depth;
-            entry.score = score;
-            entry.type = type;
-            entry.move = move;
+            const uint64_t data = pack(move, score, depth, type);
+
+            slot.store(key, data);
         }
     }
 
-    Entry probe(uint64_t key) 
+    // permille of the used slots, sampled on the first 1000 (UCI "hashfull")
+    [[nodiscard]] int hashfull() const
     {
-        size_t index = key & mask;
-        Entry e = table[index];
+        const size_t sample = std::min<size_t>(1000, table.size());
+        size_t used = 0;
+
+        for (size_t i = 0; i < sample; ++i)
+        {
+            if (table[i].data.load(std::memory_order_relaxed) != 0) ++used;
+        }
+
+        return static_cast<int>((used * 1000) / sample);
+    }
+
+    Entry probe(uint64_t key) const
+    {
+        Entry e = unpack(table.bucket(key));
 
         if (e.key == key) {
             return e;
@@ -116,8 +116,31 @@ public:
     }
 
 private:
-    std::vector<Entry> table;
-    size_t mask = 0;
+    [[nodiscard]] static uint64_t pack(Move move, int score, int depth, Entry::Type type)
+    {
+        return static_cast<uint64_t>(static_cast<uint16_t>(move.getPackedMove()))
+             | (static_cast<uint64_t>(static_cast<uint32_t>(score)) << 16)
+             | (static_cast<uint64_t>(depth & 0xFF) << 48)
+             | (static_cast<uint64_t>(type) << 56);
+    }
+
+    [[nodiscard]] static Entry unpack(const XorSlot &slot)
+    {
+        uint64_t data;
+        const uint64_t key = slot.load(data);
+
+        if (data == 0 && key == 0) return Entry{};
+
+        Entry e;
+        e.key   = key;
+        e.move  = Move{static_cast<uint16_t>(data)};
+        e.score = static_cast<int32_t>(static_cast<uint32_t>(data >> 16));
+        e.depth = static_cast<int>((data >> 48) & 0xFF);
+        e.type  = static_cast<Entry::Type>((data >> 56) & 0x3);
+        return e;
+    }
+
+    XorTable<XorSlot> table;
 };
 
 #endif
@@ -0,0 +1,329 @@
+// Copyright (c) 2025 Bartlomiej Kozka
+// All rights reserved.
+
+/*************** File description ****************/
+// Set-wise attack maps of the whole board
+/*************************************************/
+
+#include "AttackMaps.h"
+#include "Board.hpp"
+
+#include <array>
+#include <cstdint>
+#include <utility>
+
+// SIMD kernels are compiled when the target has them, or - on x86 GCC / Clang -
+// always, with the instruction set enabled per function
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define ATTACK_GEN_RUNTIME_CHECK
+#define ATTACK_GEN_AVX2   __attribute__((target("avx2")))
+#define ATTACK_GEN_AVX512 __attribute__((target("avx512f")))
+#elif defined(__AVX512F__)
+#include <immintrin.h>
+#define ATTACK_GEN_AVX2
+#define ATTACK_GEN_AVX512
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define ATTACK_GEN_AVX2
+#endif
+
+
+namespace
+{
+    constexpr uint64_t allSquares = 0xFFFFFFFFFFFFFFFF;
+    constexpr uint64_t notAFile   = 0xFEFEFEFEFEFEFEFE;
+    constexpr uint64_t notABFile  = 0xFCFCFCFCFCFCFCFC;
+    constexpr uint64_t notHFile   = 0x7F7F7F7F7F7F7F7F;
+    constexpr uint64_t notGHFile  = 0x3F3F3F3F3F3F3F3F;
+
+    /*
+    * Slider lanes layout - 32 lanes = [color][shift group][8 directions]
+    * Shift group: 0 - left shifts (N, E, NE, NW), 1 - right shifts (S, W, SW, SE)
+    * In every group:
+    *   0, 1 - rook    (orthogonal directions)
+    *   2, 3 - bishop  (diagonal directions)
+    *   4..7 - queen   (both of above in the same order)
+    * Thanks to this, every 4 lanes chunk shares the same shift amounts.
+    */
+    constexpr size_t laneGroup = 8;
+    constexpr size_t lanesCount = 2 * 2 * laneGroup;
+
+    constexpr std::array<uint64_t, laneGroup> laneShift = { 8, 1, 9, 7, 8, 1, 9, 7 };
+
+    // wrap masks applied after every shift
+    constexpr std::array<uint64_t, laneGroup> leftMask  = { allSquares, notAFile, notAFile, notHFile, allSquares, notAFile, notAFile, notHFile };
+    constexpr std::array<uint64_t, laneGroup> rightMask = { allSquares, notHFile, notHFile, notAFile, allSquares, notHFile, notHFile, notAFile };
+
+    using Lanes = std::array<uint64_t, lanesCount>;
+
+    [[nodiscard]] uint64_t bb(const Board &board, size_t pieceIdx, size_t color)
+    {
+        return board.bitboards[Board::align + (2 * pieceIdx) + color];
+    }
+
+    void loadGenerators(const Board &board, Lanes &lanes)
+    {
+        for (size_t color = 0; color < 2; ++color)
+        {
+            const uint64_t bishops = bb(board, 2, color);
+            const uint64_t rooks   = bb(board, 3, color);
+            const uint64_t queens  = bb(board, 4, color);
+
+            for (size_t group = 0; group < 2; ++group)
+            {
+                uint64_t *lane = &lanes[(color * 2 + group) * laneGroup];
+                lane[0] = lane[1] = rooks;
+                lane[2] = lane[3] = bishops;
+                lane[4] = lane[5] = lane[6] = lane[7] = queens;
+            }
+        }
+    }
+
+    // ---------------------------
+    // Kogge-Stone occluded fills
+    // ---------------------------
+
+    template<bool Left>
+    [[nodiscard]] constexpr uint64_t shift(uint64_t b, uint64_t s) { return Left ? (b << s) : (b >> s); }
+
+    template<bool Left>
+    void fillScalar(uint64_t *gen, uint64_t empty)
+    {
+        const auto &mask = Left ? leftMask : rightMask;
+
+        for (size_t i = 0; i < laneGroup; ++i)
+        {
+            const uint64_t s = laneShift[i];
+            uint64_t g = gen[i];
+            uint64_t pro = empty & mask[i];
+
+            g |= pro & shift<Left>(g, s);
+            pro &= shift<Left>(pro, s);
+            g |= pro & shift<Left>(g, 2 * s);
+            pro &= shift<Left>(pro, 2 * s);
+            g |= pro & shift<Left>(g, 4 * s);
+
+            gen[i] = shift<Left>(g, s) & mask[i];
+        }
+    }
+
+#if defined(ATTACK_GEN_AVX512)
+    // full-mask maskz form - same vpsllvq / vpsrlvq, but without the undefined
+    // pass-through vector the plain intrinsics trip -Wuninitialized with
+    template<bool Left>
+    [[nodiscard]] ATTACK_GEN_AVX512 __m512i shift8(__m512i b, __m512i s) { return Left ? _mm512_maskz_sllv_epi64(0xFF, b, s) : _mm512_maskz_srlv_epi64(0xFF, b, s); }
+
+    template<bool Left>
+    ATTACK_GEN_AVX512 void fillAvx512(uint64_t *gen, __m512i empty)
+    {
+        const auto &mask = Left ? leftMask : rightMask;
+
+        const __m512i m  = _mm512_loadu_si512(mask.data());
+        const __m512i s1 = _mm512_loadu_si512(laneShift.data());
+        const __m512i s2 = _mm512_add_epi64(s1, s1);
+        const __m512i s4 = _mm512_add_epi64(s2, s2);
+
+        __m512i g = _mm512_load_si512(gen);
+        __m512i pro = _mm512_and_si512(empty, m);
+
+        g   = _mm512_or_si512(g, _mm512_and_si512(pro, shift8<Left>(g, s1)));
+        pro = _mm512_and_si512(pro, shift8<Left>(pro, s1));
+        g   = _mm512_or_si512(g, _mm512_and_si512(pro, shift8<Left>(g, s2)));
+        pro = _mm512_and_si512(pro, shift8<Left>(pro, s2));
+        g   = _mm512_or_si512(g, _mm512_and_si512(pro, shift8<Left>(g, s4)));
+
+        _mm512_store_si512(gen, _mm512_and_si512(shift8<Left>(g, s1), m));
+    }
+#endif
+
+#if defined(ATTACK_GEN_AVX2)
+    template<bool Left>
+    [[nodiscard]] ATTACK_GEN_AVX2 __m256i shift4(__m256i b, __m256i s) { return Left ? _mm256_sllv_epi64(b, s) : _mm256_srlv_epi64(b, s); }
+
+    // 8 lanes group as two registers - both halves share shift amounts
+    template<bool Left>
+    ATTACK_GEN_AVX2 void fillAvx2(uint64_t *gen, __m256i empty)
+    {
+        const auto &mask = Left ? leftMask : rightMask;
+
+        const __m256i m  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(mask.data()));
+        const __m256i s1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(laneShift.data()));
+        const __m256i s2 = _mm256_add_epi64(s1, s1);
+        const __m256i s4 = _mm256_add_epi64(s2, s2);
+        const __m256i pro0 = _mm256_and_si256(empty, m);
+
+        for (size_t half = 0; half < 2; ++half)
+        {
+            auto *ptr = reinterpret_cast<__m256i*>(gen + (half * 4));
+
+            __m256i g = _mm256_load_si256(ptr);
+            __m256i pro = pro0;
+
+            g   = _mm256_or_si256(g, _mm256_and_si256(pro, shift4<Left>(g, s1)));
+            pro = _mm256_and_si256(pro, shift4<Left>(pro, s1));
+            g   = _mm256_or_si256(g, _mm256_and_si256(pro, shift4<Left>(g, s2)));
+            pro = _mm256_and_si256(pro, shift4<Left>(pro, s2));
+            g   = _mm256_or_si256(g, _mm256_and_si256(pro, shift4<Left>(g, s4)));
+
+            _mm256_store_si256(ptr, _mm256_and_si256(shift4<Left>(g, s1), m));
+        }
+    }
+#endif
+
+    // ---------------------------
+    // Leapers & pawns (set-wise)
+    // ---------------------------
+
+    [[nodiscard]] constexpr uint64_t pawnAttacks(uint64_t pawns, size_t color)
+    {
+        return color ? ((pawns >> 7) & notAFile) | ((pawns >> 9) & notHFile)
+                     : ((pawns << 9) & notAFile) | ((pawns << 7) & notHFile);
+    }
+
+    [[nodiscard]] constexpr uint64_t knightAttacks(uint64_t knights)
+    {
+        const uint64_t h1 = ((knights >> 1) & notHFile)  | ((knights << 1) & notAFile);
+        const uint64_t h2 = ((knights >> 2) & notGHFile) | ((knights << 2) & notABFile);
+        return (h1 << 16) | (h1 >> 16) | (h2 << 8) | (h2 >> 8);
+    }
+
+    [[nodiscard]] constexpr uint64_t kingAttacks(uint64_t king)
+    {
+        uint64_t attacks = ((king << 1) & notAFile) | ((king >> 1) & notHFile);
+        king |= attacks;
+        return attacks | (king << 8) | (king >> 8);
+    }
+
+    [[nodiscard]] AttackMaps collect(const Board &board, const Lanes &lanes)
+    {
+        AttackMaps maps;
+
+        for (size_t color = 0; color < 2; ++color)
+        {
+            const uint64_t *l = &lanes[color * 2 * laneGroup];
+            auto &att = maps.byPiece[color];
+
+            att[0] = pawnAttacks(bb(board, 0, color), color);
+            att[1] = knightAttacks(bb(board, 1, color));
+            att[2] = l[2] | l[3] | l[laneGroup + 2] | l[laneGroup + 3];
+            att[3] = l[0] | l[1] | l[laneGroup + 0] | l[laneGroup + 1];
+            att[4] = l[4] | l[5] | l[6] | l[7]
+                   | l[laneGroup + 4] | l[laneGroup + 5] | l[laneGroup + 6] | l[laneGroup + 7];
+            att[5] = kingAttacks(bb(board, 5, color));
+
+            maps.byColor[color] = att[0] | att[1] | att[2] | att[3] | att[4] | att[5];
+        }
+
+        return maps;
+    }
+
+#if defined(ATTACK_GEN_AVX512)
+    [[nodiscard]] ATTACK_GEN_AVX512 AttackMaps computeAvx512(const Board &board)
+    {
+        alignas(64) Lanes lanes;
+        loadGenerators(board, lanes);
+
+        const __m512i empty = _mm512_set1_epi64(static_cast<long long>(~board.fullBoard()));
+
+        for (size_t color = 0; color < 2; ++color)
+        {
+            fillAvx512<true>(&lanes[(color * 2) * laneGroup], empty);
+            fillAvx512<false>(&lanes[(color * 2 + 1) * laneGroup], empty);
+        }
+
+        return collect(board, lanes);
+    }
+#endif
+
+#if defined(ATTACK_GEN_AVX2)
+    [[nodiscard]] ATTACK_GEN_AVX2 AttackMaps computeAvx2(const Board &board)
+    {
+        alignas(64) Lanes lanes;
+        loadGenerators(board, lanes);
+
+        const __m256i empty = _mm256_set1_epi64x(static_cast<long long>(~board.fullBoard()));
+
+        for (size_t color = 0; color < 2; ++color)
+        {
+            fillAvx2<true>(&lanes[(color * 2) * laneGroup], empty);
+            fillAvx2<false>(&lanes[(color * 2 + 1) * laneGroup], empty);
+        }
+
+        return collect(board, lanes);
+    }
+#endif
+}
+
+
+[[nodiscard]] AttackMaps AttackGen::computeScalar(const Board &board)
+{
+    alignas(64) Lanes lanes;
+    loadGenerators(board, lanes);
+
+    const uint64_t empty = ~board.fullBoard();
+
+    for (size_t color = 0; color < 2; ++color)
+    {
+        fillScalar<true>(&lanes[(color * 2) * laneGroup], empty);
+        fillScalar<false>(&lanes[(color * 2 + 1) * laneGroup], empty);
+    }
+
+    return collect(board, lanes);
+}
+
+[[nodiscard]] AttackMaps AttackGen::compute(const Board &board)
+{
+#if defined(__AVX512F__)
+    return computeAvx512(board);
+#elif defined(__AVX2__)
+    return computeAvx2(board);
+#else
+    return computeScalar(board);
+#endif
+}
+
+[[nodiscard]] AttackMaps AttackGen::computeWith(Kernel kernel, const Board &board)
+{
+    switch (kernel)
+    {
+#if defined(ATTACK_GEN_AVX512)
+        case Kernel::Avx512: return computeAvx512(board);
+#endif
+#if defined(ATTACK_GEN_AVX2)
+        case Kernel::Avx2: return computeAvx2(board);
+#endif
+        default: return computeScalar(board);
+    }
+}
+
+[[nodiscard]] bool AttackGen::isSupported(Kernel kernel)
+{
+    switch (kernel)
+    {
+#if defined(ATTACK_GEN_RUNTIME_CHECK)
+        case Kernel::Avx512: return __builtin_cpu_supports("avx512f");
+        case Kernel::Avx2:   return __builtin_cpu_supports("avx2");
+#else
+    #if defined(ATTACK_GEN_AVX512)
+        case Kernel::Avx512: return true;
+    #endif
+    #if defined(ATTACK_GEN_AVX2)
+        case Kernel::Avx2: return true;
+    #endif
+#endif
+        case Kernel::Scalar: return true;
+        default: return false;
+    }
+}
+
+[[nodiscard]] const char* AttackGen::kernelName()
+{
+#if defined(__AVX512F__)
+    return "avx512";
+#elif defined(__AVX2__)
+    return "avx2";
+#else
+    return "scalar";
+#endif
+}
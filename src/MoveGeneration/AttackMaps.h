@@ -0,0 +1,84 @@
+// Copyright (c) 2025 Bartlomiej Kozka
+// All rights reserved.
+
+/*************** File description ****************/
+// Set-wise attack maps of the whole board
+/*************************************************/
+// Every piece type of both colors is processed in one
+// pass. Sliders use Kogge-Stone occluded fills, where
+// all 8 ray directions are independent lanes:
+//  - AVX-512: 8 x 64-bit lanes per register
+//  - AVX2:    4 x 64-bit lanes per register
+//  - scalar fallback when none of above is available
+// Kernel used by compute() is selected at compile time (see
+// BUILD_NATIVE_ARCH option in the main CMakeLists). On x86 with
+// GCC / Clang the SIMD kernels are built for their own target
+// anyway, so they can be run (and tested) on a generic build
+// when the CPU supports them.
+
+#ifndef ATTACK_MAPS_H
+#define ATTACK_MAPS_H
+
+#include "Board.hpp"
+
+#include <array>
+#include <cstdint>
+#include <utility>
+
+
+struct AttackMaps
+{
+    static constexpr size_t pDistinct = 6;
+
+    // [color][piece] - piece order: Pawn, Knight, Bishop, Rook, Queen, King (as in PieceDescriptor)
+    // attacks include squares occupied by own pieces (defended squares)
+    std::array<std::array<uint64_t, pDistinct>, 2> byPiece{};
+
+    // union of all piece attacks of the color
+    std::array<uint64_t, 2> byColor{};
+
+    [[nodiscard]] uint64_t get(pColor color, Piece piece) const
+    {
+        return byPiece[std::to_underlying(color)][(static_cast<size_t>(piece) - Board::align) / 2];
+    }
+
+    [[nodiscard]] uint64_t get(pColor color) const
+    {
+        return byColor[std::to_underlying(color)];
+    }
+};
+
+class AttackGen
+{
+public:
+    //--------------------
+    // Initilizers
+    //--------------------
+
+    AttackGen() = delete;
+
+    //------------------
+    // Main API function
+    //------------------
+
+    // uses the best kernel available for the compiled target
+    [[nodiscard]] static AttackMaps compute(const Board &board);
+
+    //------------------
+    // Kernels (exposed for tests and benchmarks)
+    //------------------
+
+    enum class Kernel { Scalar, Avx2, Avx512 };
+
+    [[nodiscard]] static AttackMaps computeScalar(const Board &board);
+
+    // kernel has to be supported - see isSupported()
+    [[nodiscard]] static AttackMaps computeWith(Kernel kernel, const Board &board);
+
+    // kernel is built in and the running CPU has its instructions
+    [[nodiscard]] static bool isSupported(Kernel kernel);
+
+    [[nodiscard]] static const char* kernelName();
+};
+
+#endif // ATTACK_MAPS_H
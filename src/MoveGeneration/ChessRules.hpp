@@ -18,7 +18,6 @@
 #include "Move.hpp"
 #include "BitOperation.hpp"
 #include "MoveUtils.hpp"
-#include "Perft/PerftStats.h"
 
 #define MAX_MOVES_NUMBER    (256)   // rael max is 218
 
@@ -54,8 +53,8 @@ public:
     // Initializators
     // --------------------
 
-    ChessRules(Board &board, PerftStats &perft_stats)
-        : _board{board}, _perft_stats{perft_stats} {}
+    explicit ChessRules(Board &board)
+        : _board{board} {}
 
     // --------------------
     // Methods
@@ -176,7 +175,6 @@ public:
     bool isRepetition() const;
 
     Board &_board;
-    PerftStats &_perft_stats;
 };
 
 
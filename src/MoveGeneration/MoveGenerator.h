@@ -21,6 +21,7 @@
 #include "ChessRules.hpp"
 #include "MoveUtils.hpp"
 #include "BitOperation.hpp"
+#include "Perft/PerftStats.h"
 
 #include <utility>
 #include <array>
@@ -54,10 +55,17 @@ public:
 
     [[nodiscard]] static int generateLegalMoves(ChessRules &rules, Move *moves, int *outMobilityScore = nullptr, const int *mobilityWeights = nullptr);
 
+    // StatsPolicy: NoPerftStats or PerftStats (see PerftStats.h)
+    template<typename StatsPolicy>
+    [[nodiscard]] static int generateLegalMoves(ChessRules &rules, Move *moves, StatsPolicy &stats);
+
     template<Gen GenMode>
     [[nodiscard]] static Move* generate(ChessRules &rules, Move *moves, int *outMobilityScore = nullptr, const int *mobilityWeights = nullptr);
 
 private:
+    template<typename StatsPolicy>
+    [[nodiscard]] static int generateLegal(ChessRules &rules, Move *moves, StatsPolicy &stats, int *outMobilityScore, const int *mobilityWeights);
+
     template<typename EncodeFn, typename AllowFn>
     [[nodiscard]] static Move* addTargetsAsMove(uint64_t targets, int originSq, Move *moves, EncodeFn encode, AllowFn allow, bool isPromotion);
 
@@ -101,6 +109,43 @@ private:
 // INLINE (TEMPLATES) DEFINITIONS
 // ------------------------------
 
+template<typename StatsPolicy>
+[[nodiscard]] int MoveGen::generateLegalMoves(ChessRules &rules, Move *moves, StatsPolicy &stats)
+{
+    return generateLegal(rules, moves, stats, nullptr, nullptr);
+}
+
+template<typename StatsPolicy>
+[[nodiscard]] int MoveGen::generateLegal(ChessRules &rules, Move *moves, StatsPolicy &stats, int *outMobilityScore, const int *mobilityWeights)
+{
+    Move const *startMove = moves;
+
+    if ( !rules.isCheck() )
+    {
+        moves = generate<Gen::All>(rules, moves, outMobilityScore, mobilityWeights);
+    }
+    else
+    {
+
+        if ( !rules.isDoubleCheck() )
+        {
+            moves = generate<Gen::Evasions>(rules, getKingMoves<Gen::All>(rules, moves));
+        }
+        // Double Check -> only King evasion
+        else
+        {
+            moves = getKingMoves<Gen::All>(rules, moves);
+        }
+    }
+    
+    if constexpr ( StatsPolicy::Enabled )
+    {
+        if ( moves == startMove ) stats.check_mates++;
+    }
+
+    return static_cast<int>(moves - startMove);
+}
+
 template<Gen GenMode>
 [[nodiscard]] Move* MoveGen::generate(ChessRules &rules, Move *moves, int *outMobilityScore, const int *mobilityWeights)
 {
@@ -175,7 +220,6 @@ template<Gen G, Piece P,
     bool isPromotion = false;
 
     pinned = rules.getAllPins(kingSq);
-    // if ( pinned ) rules._perft_stats.discovery_checks++;
 
     while (piecesBB)
     {
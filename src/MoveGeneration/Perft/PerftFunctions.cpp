@@ -3,6 +3,11 @@
 #include "MoveGeneration/Move.hpp"
 #include "MoveGeneration/MoveGenerator.h"
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
 
 static void countMoveStatic(Move &m, PerftStats &stats) 
 {
@@ -23,73 +28,303 @@ static void countMoveStaticCheck(ChessRules &rules, PerftStats &stats, Move &m)
     }
 }
 
-uint64_t Perft(int depth, ChessRules &rules, PerftStats &stats)
+/*
+* NoPerftStats -> bulk counting: at depth 1 the legal moves count is returned
+*                 without making the moves (leaves are never visited).
+* PerftStats   -> every leaf is made, to classify it (checks, mates, ...).
+* table        -> optional subtrees cache, used only without stats (stats can not be cached).
+*/
+template<typename StatsPolicy>
+static uint64_t perftRecursive(int depth, ChessRules &rules, StatsPolicy &stats, PerftTable *table)
 {
-    if (depth == 0) {
-        stats.nodes += 1;
-        return 1;
+    if constexpr (StatsPolicy::Enabled)
+    {
+        if (depth == 0) {
+            stats.nodes += 1;
+            return 1;
+        }
     }
 
+    if constexpr (!StatsPolicy::Enabled)
+    {
+        uint64_t cached;
+        if (table && depth > 1 && table->probe(rules._board.zobristKey, depth, cached)) return cached;
+    }
 
     std::array<Move, 256> move_list;
-    int n_moves = MoveGen::generateLegalMoves(rules, move_list.data());
+    int n_moves = MoveGen::generateLegalMoves(rules, move_list.data(), stats);
+
+    if constexpr (!StatsPolicy::Enabled)
+    {
+        if (depth == 1) return static_cast<uint64_t>(n_moves);
+    }
 
     uint64_t nodes = 0;
 
     for (int i = 0; i < n_moves; ++i) 
     {
-        countMoveStatic(move_list[i], stats);
+        if constexpr (StatsPolicy::Enabled) countMoveStatic(move_list[i], stats);
 
         rules._board.makeMove(move_list[i]);
 
-        countMoveStaticCheck(rules, stats, move_list[i]);
+        if constexpr (StatsPolicy::Enabled) countMoveStaticCheck(rules, stats, move_list[i]);
 
-        nodes += Perft(depth - 1, rules, stats);
+        nodes += perftRecursive(depth - 1, rules, stats, table);
 
         rules._board.unmakeMove();
     }
 
+    if constexpr (!StatsPolicy::Enabled)
+    {
+        if (table) table->save(rules._board.zobristKey, depth, nodes);
+    }
+
     return nodes;
 }
 
-uint64_t PerftDivide(int depth, ChessRules &rules, PerftStats &stats) 
+template<typename StatsPolicy>
+static uint64_t perftRoot(int depth, ChessRules &rules, StatsPolicy &stats, PerftTable *table)
 {
+    // nothing to count - perftRecursive would never reach its depth == 0/1 end
+    if (depth < 0) return 0;
+
+    if constexpr (!StatsPolicy::Enabled)
+    {
+        if (depth == 0) return 1;
+    }
+
+    return perftRecursive(depth, rules, stats, table);
+}
+
+template<typename StatsPolicy>
+uint64_t Perft(int depth, ChessRules &rules, StatsPolicy &stats)
+{
+    return perftRoot(depth, rules, stats, nullptr);
+}
+
+uint64_t Perft(int depth, ChessRules &rules)
+{
+    NoPerftStats noStats;
+    return perftRoot(depth, rules, noStats, nullptr);
+}
+
+uint64_t Perft(int depth, ChessRules &rules, PerftTable &table)
+{
+    NoPerftStats noStats;
+    return perftRoot(depth, rules, noStats, &table);
+}
+
+template<typename StatsPolicy>
+static uint64_t perftDivide(int depth, ChessRules &rules, StatsPolicy &stats, PerftTable *table) 
+{
+    // no root moves to divide - the position itself (depth 0) or nothing
+    if (depth <= 0) return perftRoot(depth, rules, stats, table);
+
     std::array<Move, 256> moves;
-    int moveCount = MoveGen::generateLegalMoves(rules, moves.data());
+    int moveCount = MoveGen::generateLegalMoves(rules, moves.data(), stats);
 
     uint64_t total = 0;
 
     for (int i = 0; i < moveCount; ++i) 
     {
         // optionally snapshot per-branch stats
-        PerftStats branchStats;
-        branchStats.reset();
+        StatsPolicy branchStats{};
 
         // count static features for the root move (so branchStats will include them)
-        countMoveStatic(moves[i], branchStats);
+        if constexpr (StatsPolicy::Enabled) countMoveStatic(moves[i], branchStats);
 
         rules._board.makeMove(moves[i]);
 
-        countMoveStaticCheck(rules, stats, moves[i]);
+        if constexpr (StatsPolicy::Enabled) countMoveStaticCheck(rules, stats, moves[i]);
 
-        uint64_t nodes = Perft(depth - 1, rules, branchStats);
+        uint64_t nodes = perftRoot(depth - 1, rules, branchStats, table);
 
         rules._board.unmakeMove();
 
         std::cout << SimpleParser::moveToString(moves[i].OriginSq(), moves[i].TargetSq());
         std::cout << ": " << nodes << "\n";
 
-        stats.nodes += branchStats.nodes;
-        stats.captures += branchStats.captures;
-        stats.promotions += branchStats.promotions;
-        stats.castles += branchStats.castles;
-        stats.enPassantCaptures += branchStats.enPassantCaptures;
-        stats.checks += branchStats.checks;
-        stats.double_checks += branchStats.double_checks;
-        stats.discovery_checks += branchStats.discovery_checks;
+        if constexpr (StatsPolicy::Enabled) stats += branchStats;
 
         total += nodes;
     }
 
     return total;
 }
+
+template<typename StatsPolicy>
+uint64_t PerftDivide(int depth, ChessRules &rules, StatsPolicy &stats)
+{
+    return perftDivide(depth, rules, stats, nullptr);
+}
+
+uint64_t PerftDivide(int depth, ChessRules &rules)
+{
+    NoPerftStats noStats;
+    return perftDivide(depth, rules, noStats, nullptr);
+}
+
+uint64_t PerftDivide(int depth, ChessRules &rules, PerftTable &table)
+{
+    NoPerftStats noStats;
+    return perftDivide(depth, rules, noStats, &table);
+}
+
+// ---------------------------
+// Parallel perft
+// ---------------------------
+
+namespace
+{
+    // Single unit of work: root move, or root move + reply (deeper split for better balance)
+    struct PerftTask
+    {
+        int rootIdx;
+        int length;
+        std::array<Move, 2> moves;
+    };
+}
+
+template<typename StatsPolicy>
+static uint64_t perftParallel(int depth, ChessRules &rules, StatsPolicy &stats, int threads, PerftTable *table, bool divide)
+{
+    if (threads <= 0) threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+    // nothing worth splitting
+    if (depth < 2) return divide ? perftDivide(depth, rules, stats, table) : perftRoot(depth, rules, stats, table);
+
+    std::array<Move, 256> rootMoves;
+    int rootCount = MoveGen::generateLegalMoves(rules, rootMoves.data(), stats);
+
+    // split on 2 plies when the subtrees are big enough, there are only ~20-40 root moves
+    const bool splitReplies = (depth >= 3);
+
+    std::vector<PerftTask> tasks;
+    for (int i = 0; i < rootCount; ++i)
+    {
+        if (!splitReplies)
+        {
+            tasks.push_back({ i, 1, { rootMoves[i], Move{0} } });
+            continue;
+        }
+
+        // first ply is counted here, once per root move (as in the single threaded recursion)
+        if constexpr (StatsPolicy::Enabled) countMoveStatic(rootMoves[i], stats);
+
+        rules._board.makeMove(rootMoves[i]);
+
+        if constexpr (StatsPolicy::Enabled) countMoveStaticCheck(rules, stats, rootMoves[i]);
+
+        std::array<Move, 256> replies;
+        int replyCount = MoveGen::generateLegalMoves(rules, replies.data(), stats);
+        for (int j = 0; j < replyCount; ++j)
+        {
+            tasks.push_back({ i, 2, { rootMoves[i], replies[j] } });
+        }
+
+        rules._board.unmakeMove();
+    }
+
+    std::vector<uint64_t> results(tasks.size(), 0);
+    std::vector<StatsPolicy> workersStats(static_cast<size_t>(threads));
+    std::atomic<size_t> nextTask{0};
+
+    // every worker owns its Board copy, tasks are taken one by one from the shared counter
+    auto worker = [&](int id)
+    {
+        Board board = rules._board;
+        ChessRules workerRules{board};
+        StatsPolicy localStats{};
+
+        for (size_t t = nextTask.fetch_add(1); t < tasks.size(); t = nextTask.fetch_add(1))
+        {
+            PerftTask task = tasks[t];
+
+            if (task.length == 2) board.makeMove(task.moves[0]);
+
+            Move &m = task.moves[task.length - 1];
+
+            if constexpr (StatsPolicy::Enabled) countMoveStatic(m, localStats);
+
+            board.makeMove(m);
+
+            if constexpr (StatsPolicy::Enabled) countMoveStaticCheck(workerRules, localStats, m);
+
+            results[t] = perftRecursive(depth - task.length, workerRules, localStats, table);
+
+            board.unmakeMove();
+            if (task.length == 2) board.unmakeMove();
+        }
+
+        workersStats[static_cast<size_t>(id)] = localStats;
+    };
+
+    std::vector<std::thread> pool;
+    for (int id = 1; id < threads; ++id)
+    {
+        pool.emplace_back(worker, id);
+    }
+    worker(0);
+    for (auto &th : pool) th.join();
+
+    if constexpr (StatsPolicy::Enabled)
+    {
+        for (const auto &ws : workersStats) stats += ws;
+    }
+
+    std::vector<uint64_t> rootNodes(static_cast<size_t>(rootCount), 0);
+    for (size_t t = 0; t < tasks.size(); ++t)
+    {
+        rootNodes[static_cast<size_t>(tasks[t].rootIdx)] += results[t];
+    }
+
+    uint64_t total = 0;
+    for (int i = 0; i < rootCount; ++i)
+    {
+        if (divide)
+        {
+            std::cout << SimpleParser::moveToString(rootMoves[i].OriginSq(), rootMoves[i].TargetSq());
+            std::cout << ": " << rootNodes[i] << "\n";
+        }
+        total += rootNodes[i];
+    }
+
+    return total;
+}
+
+template<typename StatsPolicy>
+uint64_t PerftParallel(int depth, ChessRules &rules, StatsPolicy &stats, int threads, PerftTable *table)
+{
+    return perftParallel(depth, rules, stats, threads, table, false);
+}
+
+uint64_t PerftParallel(int depth, ChessRules &rules, int threads, PerftTable *table)
+{
+    NoPerftStats noStats;
+    return perftParallel(depth, rules, noStats, threads, table, false);
+}
+
+template<typename StatsPolicy>
+uint64_t PerftDivideParallel(int depth, ChessRules &rules, StatsPolicy &stats, int threads, PerftTable *table)
+{
+    return perftParallel(depth, rules, stats, threads, table, true);
+}
+
+uint64_t PerftDivideParallel(int depth, ChessRules &rules, int threads, PerftTable *table)
+{
+    NoPerftStats noStats;
+    return perftParallel(depth, rules, noStats, threads, table, true);
+}
+
+// ---------------------------
+// Explicit instantiations
+// ---------------------------
+
+template uint64_t Perft<NoPerftStats>(int, ChessRules&, NoPerftStats&);
+template uint64_t Perft<PerftStats>(int, ChessRules&, PerftStats&);
+template uint64_t PerftDivide<NoPerftStats>(int, ChessRules&, NoPerftStats&);
+template uint64_t PerftDivide<PerftStats>(int, ChessRules&, PerftStats&);
+template uint64_t PerftParallel<NoPerftStats>(int, ChessRules&, NoPerftStats&, int, PerftTable*);
+template uint64_t PerftParallel<PerftStats>(int, ChessRules&, PerftStats&, int, PerftTable*);
+template uint64_t PerftDivideParallel<NoPerftStats>(int, ChessRules&, NoPerftStats&, int, PerftTable*);
+template uint64_t PerftDivideParallel<PerftStats>(int, ChessRules&, PerftStats&, int, PerftTable*);
@@ -2,15 +2,48 @@
 #define PERFT_FUNCTIONS_H
 
 #include "PerftStats.h"
+#include "PerftTable.h"
 #include "MoveGeneration/ChessRules.hpp"
 
 #include <array>
 #include <cstdint>
 
 
-uint64_t Perft(int depth, ChessRules &rules, PerftStats &stats);
+// StatsPolicy (see PerftStats.h):
+//  - NoPerftStats -> nodes count only, bulk counting at depth 1 (the fastest variant)
+//  - PerftStats   -> every leaf is made to collect the stats
+// Instantiated in PerftFunctions.cpp for both policies.
+// Depth 0 counts the position itself (1), negative depth - nothing (0).
 
-uint64_t PerftDivide(int depth, ChessRules &rules, PerftStats &stats);
+template<typename StatsPolicy>
+uint64_t Perft(int depth, ChessRules &rules, StatsPolicy &stats);
+
+uint64_t Perft(int depth, ChessRules &rules);
+
+// Nodes count with subtrees cached in the table (no stats - they can not be cached)
+uint64_t Perft(int depth, ChessRules &rules, PerftTable &table);
+
+template<typename StatsPolicy>
+uint64_t PerftDivide(int depth, ChessRules &rules, StatsPolicy &stats);
+
+uint64_t PerftDivide(int depth, ChessRules &rules);
+
+uint64_t PerftDivide(int depth, ChessRules &rules, PerftTable &table);
+
+// Multithreaded variants - root moves (or root move + reply pairs) are split across
+// `threads` workers (<= 0 -> all hardware threads), each working on its own Board copy.
+// Divide output, nodes and stats are the same as in the single threaded ones.
+// The table (optional) is shared by all the workers.
+
+template<typename StatsPolicy>
+uint64_t PerftParallel(int depth, ChessRules &rules, StatsPolicy &stats, int threads, PerftTable *table = nullptr);
+
+uint64_t PerftParallel(int depth, ChessRules &rules, int threads, PerftTable *table = nullptr);
+
+template<typename StatsPolicy>
+uint64_t PerftDivideParallel(int depth, ChessRules &rules, StatsPolicy &stats, int threads, PerftTable *table = nullptr);
+
+uint64_t PerftDivideParallel(int depth, ChessRules &rules, int threads, PerftTable *table = nullptr);
 
 
 #endif
@@ -5,20 +5,46 @@
 #include <iostream>
 #include <iomanip>
 
+/*
+* Stats policies for perft and move generator (template parameter).
+* NoPerftStats - used by search, every stats update is compiled away.
+* PerftStats   - collects the counters below.
+*/
+struct NoPerftStats
+{
+    static constexpr bool Enabled = false;
+};
+
 struct PerftStats 
 {
+    static constexpr bool Enabled = true;
+
     uint64_t nodes = 0;
     uint64_t captures = 0;
     uint64_t promotions = 0;
     uint64_t castles = 0;
     uint64_t enPassantCaptures = 0;
 
-    // these below are updated in ChessRules class by reference member to this structure
+    // these below are updated in perft after the move is made (check_mates - in MoveGen::generateLegalMoves)
     uint64_t checks = 0;
     uint64_t discovery_checks = 0;
     uint64_t double_checks = 0;
     uint64_t check_mates = 0;
 
+    PerftStats& operator+=(const PerftStats &other)
+    {
+        nodes += other.nodes;
+        captures += other.captures;
+        promotions += other.promotions;
+        castles += other.castles;
+        enPassantCaptures += other.enPassantCaptures;
+        checks += other.checks;
+        discovery_checks += other.discovery_checks;
+        double_checks += other.double_checks;
+        check_mates += other.check_mates;
+        return *this;
+    }
+
     void reset() {
         nodes = captures = promotions = castles = enPassantCaptures = 
             checks = discovery_checks = double_checks = check_mates = 0;
@@ -0,0 +1,122 @@
+#include "PerftSuite.h"
+#include "PerftFunctions.h"
+#include "PerftTable.h"
+#include "Board.hpp"
+#include "MoveGeneration/ChessRules.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+
+
+namespace
+{
+    std::string trim(const std::string &s)
+    {
+        const auto first = s.find_first_not_of(" \t\r");
+        if (first == std::string::npos) return "";
+        const auto last = s.find_last_not_of(" \t\r");
+        return s.substr(first, last - first + 1);
+    }
+
+    // EPD positions come without halfmove/fullmove fields, Board::loadFromFEN needs them
+    std::string completeFen(const std::string &fen)
+    {
+        std::istringstream iss(fen);
+        std::string field;
+        int fields = 0;
+        while (iss >> field) ++fields;
+
+        return (fields == 4) ? fen + " 0 1" : fen;
+    }
+}
+
+
+[[nodiscard]] std::vector<PerftSuiteEntry> LoadPerftSuite(const std::string &path)
+{
+    std::vector<PerftSuiteEntry> suite;
+    std::ifstream file(path);
+    std::string line;
+
+    while (std::getline(file, line))
+    {
+        line = trim(line);
+        if (line.empty() || line[0] == '#') continue;
+
+        std::istringstream ss(line);
+        std::string part;
+        PerftSuiteEntry entry;
+
+        std::getline(ss, part, ';');
+        entry.fen = completeFen(trim(part));
+
+        while (std::getline(ss, part, ';'))
+        {
+            std::istringstream depthSs(trim(part));
+            std::string tag;
+            uint64_t nodes = 0;
+
+            if ((depthSs >> tag >> nodes) && tag.size() > 1 && tag[0] == 'D')
+            {
+                entry.expected.emplace_back(std::stoi(tag.substr(1)), nodes);
+            }
+        }
+
+        suite.push_back(std::move(entry));
+    }
+
+    return suite;
+}
+
+bool RunPerftSuite(const std::vector<PerftSuiteEntry> &suite, const PerftSuiteOptions &options, std::ostream &os)
+{
+    using Clock = std::chrono::steady_clock;
+
+    std::unique_ptr<PerftTable> table;
+    if (options.hashMB > 0) table = std::make_unique<PerftTable>(options.hashMB);
+
+    bool allPassed = true;
+    uint64_t totalNodes = 0;
+    double totalSeconds = 0;
+
+    for (size_t i = 0; i < suite.size(); ++i)
+    {
+        const PerftSuiteEntry &entry = suite[i];
+
+        Board board{};
+        ChessRules rules{board};
+        board.init();
+        board.loadFromFEN(entry.fen);
+
+        os << "Position " << (i + 1) << ": " << entry.fen << "\n";
+
+        for (const auto &[depth, expected] : entry.expected)
+        {
+            if (options.maxDepth > 0 && depth > options.maxDepth) continue;
+
+            auto start = Clock::now();
+            uint64_t nodes = PerftParallel(depth, rules, options.threads, table.get());
+            double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+            const bool ok = (nodes == expected);
+            allPassed = allPassed && ok;
+            totalNodes += nodes;
+            totalSeconds += seconds;
+
+            os << "  depth " << std::setw(2) << depth
+               << "  nodes " << std::setw(12) << nodes
+               << "  time " << std::setw(9) << std::fixed << std::setprecision(1) << seconds * 1000.0 << " ms"
+               << "  nps " << std::setw(11) << static_cast<uint64_t>(seconds > 0 ? nodes / seconds : 0)
+               << "  " << (ok ? "OK" : "FAIL (expected " + std::to_string(expected) + ")") << "\n";
+        }
+    }
+
+    os << "Total nodes " << totalNodes
+       << "  time " << std::fixed << std::setprecision(1) << totalSeconds * 1000.0 << " ms"
+       << "  nps " << static_cast<uint64_t>(totalSeconds > 0 ? totalNodes / totalSeconds : 0)
+       << "  -> " << (allPassed ? "PASSED" : "FAILED") << "\n";
+
+    return allPassed;
+}
@@ -0,0 +1,35 @@
+#ifndef PERFT_SUITE_H
+#define PERFT_SUITE_H
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+/*
+* EPD perft suite, one position per line:
+*   <fen (4 or 6 fields)> ;D1 <nodes> ;D2 <nodes> ...
+* Empty lines and lines starting with '#' are skipped.
+*/
+struct PerftSuiteEntry
+{
+    std::string fen;
+    std::vector<std::pair<int, uint64_t>> expected;     // (depth, nodes)
+};
+
+struct PerftSuiteOptions
+{
+    int maxDepth = 0;       // 0 -> every depth given in the file
+    int threads = 1;
+    int hashMB = 0;         // 0 -> no perft hash table
+};
+
+[[nodiscard]] std::vector<PerftSuiteEntry> LoadPerftSuite(const std::string &path);
+
+// Runs every position up to maxDepth, reports nodes, time and nps per position.
+// return: true when every count matched
+bool RunPerftSuite(const std::vector<PerftSuiteEntry> &suite, const PerftSuiteOptions &options, std::ostream &os = std::cout);
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef PERFT_TABLE_H
+#define PERFT_TABLE_H
+
+#include "Shared/XorTable.h"
+
+#include <cstdint>
+#include <cstddef>
+
+
+/*
+* Hash table for perft subtrees: (zobrist key, depth) -> nodes count.
+* Shared by the perft threads without locks (see Shared/XorTable.h).
+*
+* data packing: bits 0-7 depth, bits 8-63 nodes count
+* Bucket of 2 slots: [0] depth-preferred, [1] always replaced.
+*/
+class PerftTable
+{
+public:
+    // ------------------------
+    // Initialization
+    // ------------------------
+
+    explicit PerftTable(int sizeInMB = 16)
+    {
+        resize(sizeInMB);
+    }
+
+    // ------------------------
+    // Modification
+    // ------------------------
+
+    // size is rounded down to the power of two buckets count
+    void resize(int sizeInMB)
+    {
+        table.resize(sizeInMB);
+    }
+
+    void clear()
+    {
+        table.clear();
+    }
+
+    void save(uint64_t key, int depth, uint64_t nodes)
+    {
+        Bucket &bucket = table.bucket(key);
+        const uint64_t data = (nodes << depthBits) | static_cast<uint64_t>(depth);
+
+        XorSlot &deep = bucket.slots[0];
+        const uint64_t deepData = deep.data.load(std::memory_order_relaxed);
+        XorSlot &slot = (static_cast<int>(deepData & depthMask) <= depth) ? deep : bucket.slots[1];
+
+        slot.store(key, data);
+    }
+
+    [[nodiscard]] bool probe(uint64_t key, int depth, uint64_t &nodes) const
+    {
+        const Bucket &bucket = table.bucket(key);
+
+        for (const XorSlot &s : bucket.slots)
+        {
+            uint64_t data;
+            if ( s.load(data) == key && static_cast<int>(data & depthMask) == depth )
+            {
+                nodes = data >> depthBits;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+private:
+    static constexpr int depthBits = 8;
+    static constexpr uint64_t depthMask = (1ULL << depthBits) - 1;
+
+    struct alignas(32) Bucket
+    {
+        XorSlot slots[2];
+
+        void clear()
+        {
+            for (XorSlot &s : slots) s.clear();
+        }
+    };
+
+    XorTable<Bucket> table;
+};
+
+#endif
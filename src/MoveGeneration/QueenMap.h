@@ -27,7 +27,7 @@ public:
     // Main API function
     //------------------
 
-    [[nodiscard("PURE FUN")]] static constexpr uint64_t getMoves(const int originSq, const uint64_t bbUs, const uint64_t bbThem)
+    [[nodiscard("PURE FUN")]] static uint64_t getMoves(const int originSq, const uint64_t bbUs, const uint64_t bbThem)
     {
         return Bishop::getMoves(originSq, bbUs, bbThem) | Rook::getMoves(originSq, bbUs, bbThem);
     }
@@ -0,0 +1,88 @@
+#ifndef XOR_TABLE_H
+#define XOR_TABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+
+/*
+* Lock-free hash table storage (xor trick), used by the transposition
+* table and the perft table - both are shared by many threads.
+*
+* Every slot is two atomic words: data and key^data. They are written
+* and read separately (relaxed), so concurrent writers can leave a slot
+* with the words of two different entries. Such a slot yields a key which
+* doesn't match the probed one and reads as a miss - no locks are needed,
+* the cost is an occasional lost entry.
+*/
+struct XorSlot
+{
+    std::atomic<uint64_t> check{0};
+    std::atomic<uint64_t> data{0};
+
+    void store(uint64_t key, uint64_t value)
+    {
+        check.store(key ^ value, std::memory_order_relaxed);
+        data.store(value, std::memory_order_relaxed);
+    }
+
+    // returns the key of the stored value - garbage for a torn slot, 0 for an empty one
+    [[nodiscard]] uint64_t load(uint64_t &value) const
+    {
+        value = data.load(std::memory_order_relaxed);
+        return check.load(std::memory_order_relaxed) ^ value;
+    }
+
+    void clear()
+    {
+        check.store(0, std::memory_order_relaxed);
+        data.store(0, std::memory_order_relaxed);
+    }
+};
+
+// Power of two array of buckets indexed by the low key bits.
+// Bucket - XorSlot or a group of them, has to provide clear().
+template<typename Bucket>
+class XorTable
+{
+public:
+    // size is rounded down to the power of two buckets count (at least 1), returns the count
+    size_t resize(int sizeInMB)
+    {
+        const size_t count = (static_cast<size_t>(sizeInMB) * 1024 * 1024) / sizeof(Bucket);
+
+        size_t powerOf2 = 1;
+        while (powerOf2 * 2 <= count) {
+            powerOf2 *= 2;
+        }
+
+        table = std::make_unique<Bucket[]>(powerOf2);
+
+        // mask for indexing instead of modulo, e.g. 4096 buckets -> 4095
+        mask = powerOf2 - 1;
+
+        clear();
+        return powerOf2;
+    }
+
+    void clear()
+    {
+        for (size_t i = 0; i <= mask; ++i) table[i].clear();
+    }
+
+    [[nodiscard]] size_t size() const { return mask + 1; }
+
+    [[nodiscard]] Bucket& bucket(uint64_t key) { return table[key & mask]; }
+
+    [[nodiscard]] const Bucket& bucket(uint64_t key) const { return table[key & mask]; }
+
+    [[nodiscard]] const Bucket& operator[](size_t index) const { return table[index]; }
+
+private:
+    std::unique_ptr<Bucket[]> table;
+    size_t mask = 0;
+};
+
+#endif
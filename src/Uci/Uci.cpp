@@ -9,6 +9,9 @@
 #include "MoveGeneration/MoveGenerator.h"
 #include "MoveGeneration/Move.hpp"
 #include "MoveParser.h"
+#include "MoveGeneration/Perft/PerftFunctions.h"
+
+#include <chrono>
 
 
 void UCI::loop()
@@ -28,12 +31,13 @@ void UCI::loop()
             std::cout << "id name Barkoz-Tempo" << std::endl;
             std::cout << "id author BartlomiejKozka" << std::endl;
             std::cout << "option name Move Overhead type spin default 0 min 0 max 5000" << std::endl;
-            std::cout << "option name Threads type spin default 1 min 1 max 4" << std::endl;            // not implemented
+            std::cout << "option name Threads type spin default 1 min 1 max " << Search::maxThreads << std::endl;
             std::cout << "option name Hash type spin default 16 min 1 max 1024" << std::endl;
+            std::cout << "option name MultiPV type spin default 1 min 1 max " << Search::maxMultiPv << std::endl;
             std::cout << "option name SyzygyPath type string default <empty>" << std::endl;             // not implemented
             std::cout << "option name UCI_ShowWDL type check default false" << std::endl;               // not implemented
             
-            std::cout << "option name Ponder type check default false" << std::endl;                    // not implemented
+            std::cout << "option name Ponder type check default false" << std::endl;
             std::cout << "option name UCI_Chess960 type check default false" << std::endl;              // not implemented
             std::cout << "uciok" << std::endl;
         }
@@ -57,14 +61,18 @@ void UCI::loop()
         {
             parseGo(ss);
         } 
+        else if (token == "ponderhit")
+        {
+            searchEngine.ponderhit();
+        }
         else if (token == "stop")
         {
-            searchEngine.stopRequest = true;
+            searchEngine.stop();
             if (searchThread.joinable()) searchThread.join();
         } 
         else if (token == "quit") 
         {
-            searchEngine.stopRequest = true;
+            searchEngine.stop();
             if (searchThread.joinable()) searchThread.join();
             break;
         }
@@ -102,10 +110,41 @@ void UCI::parseSetOption(std::istringstream& ss)
             // ignore
         }
     }
-    else if (name == "Threads" || name == "UCI_ShowWDL" || 
+    else if (name == "Threads")
+    {
+        // joining a running "go infinite" / ponder search would block the loop - "stop" couldn't be read
+        if (searchEngine.searching)
+        {
+            std::cout << "info string Threads can not be changed during the search" << std::endl;
+            return;
+        }
+
+        if (searchThread.joinable()) searchThread.join();
+        try {
+            searchEngine.setThreads(std::stoi(value));
+        } catch (...) {
+            // ignore
+        }
+    }
+    else if (name == "MultiPV")
+    {
+        if (searchEngine.searching)
+        {
+            std::cout << "info string MultiPV can not be changed during the search" << std::endl;
+            return;
+        }
+
+        if (searchThread.joinable()) searchThread.join();
+        try {
+            searchEngine.setMultiPv(std::stoi(value));
+        } catch (...) {
+            // ignore
+        }
+    }
+    else if (name == "UCI_ShowWDL" || 
                 name == "Ponder" || name == "UCI_Chess960")
     {
-        // ignore, for now only 1 thread for search
+        // ignore
     }
     else if (name == "Hash") 
     {
@@ -138,6 +177,12 @@ void UCI::parsePosition(std::istringstream& ss)
     {
         while (ss >> token) 
         {
+            if (rules._board.ply >= Search::maxRootPly)
+            {
+                std::cerr << "Blad: Partia dluzsza niz " << Search::maxRootPly << " polruchow, reszta ruchow pominieta" << std::endl;
+                break;
+            }
+
             auto parsedMove = SimpleParser::parseMoveString(token);
             int from = parsedMove.from;
             int to = parsedMove.to;
@@ -191,6 +236,7 @@ void UCI::parseGo(std::istringstream& ss)
     int wtime = 0, btime = 0, winc = 0, binc = 0;
     int movetime = -1;
     int movestogo = -1;
+    bool ponder = false;
 
     while (ss >> token) 
     {
@@ -201,50 +247,62 @@ void UCI::parseGo(std::istringstream& ss)
         else if (token == "depth") ss >> depth;
         else if (token == "movetime") ss >> movetime;
         else if (token == "movestogo") ss >> movestogo;
+        else if (token == "ponder") ponder = true;
+        else if (token == "perft")
+        {
+            int perftDepth = 1;
+            ss >> perftDepth;
+            goPerft(perftDepth);
+            return;
+        }
     }
 
-    int timeForMove = 0;
-    
-    if (movetime != -1) 
-    {
-        timeForMove = movetime - moveOverhead - 10; 
-        if (timeForMove < 10) timeForMove = 10;
-    } 
-    else if (wtime > 0 || btime > 0)
-    {
-        bool isWhiteToMove = (rules._board.sideToMove == pColor::White);
-        
-        int myTime = isWhiteToMove ? wtime : btime;
-        int myInc  = isWhiteToMove ? winc  : binc;
+    const bool isWhiteToMove = (rules._board.sideToMove == pColor::White);
 
-        myTime = myTime - moveOverhead;
-        if (myTime < 0) myTime = 0;
+    TimeLimits limits;
+    limits.time = isWhiteToMove ? wtime : btime;
+    limits.inc = isWhiteToMove ? winc : binc;
+    limits.movesToGo = movestogo;
+    limits.moveTime = movetime;
+    limits.moveOverhead = moveOverhead;
 
-        if (movestogo != -1)
-        {
-            int movesLeft = (movestogo > 30) ? 30 : (movestogo + 1); 
-            timeForMove = (myTime / movesLeft) + myInc;
-        }
-        else
-        {
-            timeForMove = (myTime / 30) + myInc;
-        }
-        
-        timeForMove -= 50; 
-        if (timeForMove < 50) timeForMove = 50;
-    }
+    const bool timed = (movetime > 0) || (limits.time > 0) || (limits.inc > 0);
 
-    if (depth == -1 && timeForMove == 0) depth = 6;
-    if (timeForMove > 0 && depth == -1) depth = 64;
+    if (depth == -1) depth = timed ? 64 : 6;
 
     if (searchThread.joinable()) searchThread.join();
 
     searchEngine.stopRequest = false; 
+    searchEngine.ponder = ponder;
+    searchEngine.searching = true;
 
     ChessRules rulesForThread = rules; 
 
-    searchThread = std::thread([this, rulesForThread, depth, timeForMove]() mutable 
+    searchThread = std::thread([this, rulesForThread, depth, limits]() mutable 
     {
-        this->searchEngine.searchPosition(rulesForThread, depth, timeForMove);
+        this->searchEngine.searchPosition(rulesForThread, depth, limits);
     });
 }
+
+void UCI::goPerft(int depth)
+{
+    if (depth < 1)
+    {
+        std::cout << "info string perft depth has to be at least 1" << std::endl;
+        return;
+    }
+
+    if (searchThread.joinable()) searchThread.join();
+
+    Board perftBoard = rules._board;
+    ChessRules perftRules{perftBoard};
+
+    auto start = std::chrono::steady_clock::now();
+    uint64_t nodes = PerftDivide(depth, perftRules);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+    uint64_t nps = (elapsed > 0) ? (nodes * 1000 / elapsed) : nodes;
+
+    std::cout << "\nNodes searched: " << nodes << "\n";
+    std::cout << "info nodes " << nodes << " time " << elapsed << " nps " << nps << std::endl;
+}
@@ -44,6 +44,9 @@ private:
     void parsePosition(std::istringstream& ss);
 
     void parseGo(std::istringstream& ss);
+
+    // "go perft <depth>" - divide of the current position, nodes/time/nps
+    void goPerft(int depth);
 };
 
 #endif
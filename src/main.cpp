@@ -18,8 +18,7 @@ int main()
 {
     PieceMap::init();
     Board board{};
-    PerftStats perft_stats{};
-    ChessRules rules{board, perft_stats};
+    ChessRules rules{board};
     board.init();
     Evaluation::init();
 
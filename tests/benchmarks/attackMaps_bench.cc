@@ -0,0 +1,125 @@
+// Copyright (c) 2025 Bartlomiej Kozka
+// All rights reserved.
+
+/*************** File description ****************/
+// Benchmark: whole board attack maps, set-wise kernel
+// vs. repeated magic lookups per piece
+/*************************************************/
+
+#include "MoveGeneration/AttackMaps.h"
+#include "MoveGeneration/BishopMap.h"
+#include "MoveGeneration/RookMap.h"
+#include "MoveGeneration/QueenMap.h"
+#include "MoveGeneration/KnightPattern.hpp"
+#include "MoveGeneration/KingPattern.hpp"
+#include "Board.hpp"
+#include "BitOperation.hpp"
+#include "PieceMap.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+    const std::array<std::string, 6> fens = {
+        "",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+        "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10"
+    };
+
+    // what the evaluation would have to do today: one lookup per piece
+    AttackMaps magicLookups(const Board &board)
+    {
+        AttackMaps maps;
+        const uint64_t occ = board.fullBoard();
+
+        for (size_t color = 0; color < 2; ++color)
+        {
+            auto &att = maps.byPiece[color];
+
+            uint64_t pawns = board.bitboards[2 + color];
+            uint64_t knights = board.bitboards[4 + color];
+            uint64_t bishops = board.bitboards[6 + color];
+            uint64_t rooks = board.bitboards[8 + color];
+            uint64_t queens = board.bitboards[10 + color];
+            uint64_t king = board.bitboards[12 + color];
+
+            att[0] = color ? ((pawns >> 7) & 0xFEFEFEFEFEFEFEFE) | ((pawns >> 9) & 0x7F7F7F7F7F7F7F7F)
+                           : ((pawns << 9) & 0xFEFEFEFEFEFEFEFE) | ((pawns << 7) & 0x7F7F7F7F7F7F7F7F);
+            while (knights) att[1] |= KnightPattern::attacksTo[pop_1st(knights)];
+            while (bishops) att[2] |= Bishop::getMoves(pop_1st(bishops), 0, occ);
+            while (rooks)   att[3] |= Rook::getMoves(pop_1st(rooks), 0, occ);
+            while (queens)  att[4] |= Queen::getMoves(pop_1st(queens), 0, occ);
+            while (king)    att[5] |= KingPattern::attacksTo[pop_1st(king)];
+
+            maps.byColor[color] = att[0] | att[1] | att[2] | att[3] | att[4] | att[5];
+        }
+
+        return maps;
+    }
+
+    template<typename Fn>
+    void run(const char *name, const std::vector<Board> &boards, int iterations, Fn fn)
+    {
+        uint64_t sink = 0;
+        auto start = std::chrono::steady_clock::now();
+
+        for (int it = 0; it < iterations; ++it)
+        {
+            for (const Board &b : boards)
+            {
+                AttackMaps maps = fn(b);
+                sink ^= maps.byColor[0] ^ (maps.byColor[1] + static_cast<uint64_t>(it));
+            }
+        }
+
+        auto end = std::chrono::steady_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(end - start).count();
+        double perPos = ns / (static_cast<double>(iterations) * static_cast<double>(boards.size()));
+
+        std::cout << std::left << std::setw(16) << name
+                  << std::right << std::setw(10) << std::fixed << std::setprecision(2) << perPos << " ns/pos"
+                  << "   (checksum " << std::hex << sink << std::dec << ")\n";
+    }
+}
+
+
+int main(int argc, char **argv)
+{
+    int iterations = (argc > 1) ? std::atoi(argv[1]) : 2'000'000;
+
+    PieceMap::init();
+
+    std::vector<Board> boards;
+    for (const auto &fen : fens)
+    {
+        Board b{};
+        b.init();
+        b.loadFromFEN(fen);
+        boards.push_back(b);
+    }
+
+    std::cout << "Attack maps benchmark, compiled kernel: " << AttackGen::kernelName()
+              << ", positions: " << boards.size() << ", iterations: " << iterations << "\n";
+
+    run("magic lookups", boards, iterations, magicLookups);
+    run("fill scalar", boards, iterations, AttackGen::computeScalar);
+    run("fill compiled", boards, iterations, AttackGen::compute);
+
+    if (AttackGen::isSupported(AttackGen::Kernel::Avx2))
+        run("fill avx2", boards, iterations, [](const Board &b) { return AttackGen::computeWith(AttackGen::Kernel::Avx2, b); });
+    if (AttackGen::isSupported(AttackGen::Kernel::Avx512))
+        run("fill avx512", boards, iterations, [](const Board &b) { return AttackGen::computeWith(AttackGen::Kernel::Avx512, b); });
+
+    return 0;
+}
@@ -0,0 +1,40 @@
+// Copyright (c) 2025 Bartlomiej Kozka
+// All rights reserved.
+
+/*************** File description ****************/
+// Native perft driver: EPD suite -> nodes, time, nps
+/*************************************************/
+// usage: perft_bench <suite.epd> [maxDepth=0 (all)] [threads=1] [hashMB=0]
+
+#include "MoveGeneration/Perft/PerftSuite.h"
+#include "PieceMap.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "usage: " << argv[0] << " <suite.epd> [maxDepth] [threads] [hashMB]\n";
+        return 2;
+    }
+
+    PerftSuiteOptions options;
+    if (argc > 2) options.maxDepth = std::atoi(argv[2]);
+    if (argc > 3) options.threads  = std::atoi(argv[3]);
+    if (argc > 4) options.hashMB   = std::atoi(argv[4]);
+
+    PieceMap::init();
+
+    auto suite = LoadPerftSuite(argv[1]);
+    if (suite.empty())
+    {
+        std::cerr << "No positions loaded from " << argv[1] << "\n";
+        return 2;
+    }
+
+    return RunPerftSuite(suite, options) ? 0 : 1;
+}
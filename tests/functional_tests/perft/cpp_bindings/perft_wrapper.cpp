@@ -1,16 +1,18 @@
 #include <pybind11/pybind11.h>
 
 #include "MoveGeneration/Perft/PerftFunctions.h"
-#include "MoveGeneration/Perft/PerftStats.h"
+#include "MoveGeneration/Perft/PerftTable.h"
 #include "Board.hpp"
 #include "MoveGeneration/ChessRules.hpp"
 #include "PieceMap.hpp"
 
+#include <memory>
+
 
 namespace py = pybind11;
 
 
-uint64_t run_perft_simple(const std::string fen, int depth) 
+uint64_t run_perft_simple(const std::string fen, int depth, int hash_mb) 
 {    
     static bool is_global_init = false;
     if (!is_global_init) 
@@ -20,13 +22,26 @@ uint64_t run_perft_simple(const std::string fen, int depth)
     }
 
     Board board{};
-    PerftStats stats{};
-    ChessRules rules{board, stats};
+    ChessRules rules{board};
 
     board.init();
     board.loadFromFEN(fen);
 
-    return Perft(depth, rules, stats);
+    if (hash_mb <= 0)
+    {
+        return Perft(depth, rules);
+    }
+
+    // kept between calls - entries are keyed by full position hash and depth
+    static std::unique_ptr<PerftTable> table;
+    static int table_mb = 0;
+    if (!table || table_mb != hash_mb)
+    {
+        table = std::make_unique<PerftTable>(hash_mb);
+        table_mb = hash_mb;
+    }
+
+    return Perft(depth, rules, *table);
 }
 
 PYBIND11_MODULE( PyPerft, m, py::mod_gil_not_used() ) 
@@ -36,7 +51,7 @@ PYBIND11_MODULE( PyPerft, m, py::mod_gil_not_used() )
     m.def(
         "run_perft", 
         &run_perft_simple, 
-        "return nodes number",
-        py::arg("fen"), py::arg("depth")
+        "return nodes number, hash_mb > 0 enables the perft hash table of that size",
+        py::arg("fen"), py::arg("depth"), py::arg("hash_mb") = 0
     );
 }
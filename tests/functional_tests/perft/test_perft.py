@@ -141,3 +141,22 @@ def test_position_6_middle_game():
         result = PyPerft.run_perft(fen, depth)
         assert result == expected_results[depth], \
             f"Error for Pos 6 at depth {depth}. Expected {expected_results[depth]}, got {result}"
+
+
+def test_hash_table_deep_start_position():
+    """
+    Perft with the hash table (hash_mb > 0).
+    Subtrees are cached by position hash and depth, counts must stay exact.
+    Start position depth 7 is cheap enough with the table.
+    """
+    cases = [
+        ("", 7, 3195901860),
+        ("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 5, 193690690),
+        ("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 7, 178633661),
+        ("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 5, 15833292),
+    ]
+
+    for fen, depth, expected in cases:
+        result = PyPerft.run_perft(fen, depth, hash_mb=64)
+        assert result == expected, \
+            f"Error with hash table for '{fen}' at depth {depth}. Expected {expected}, got {result}"
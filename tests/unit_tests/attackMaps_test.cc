@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+
+#include "testUtils.h"
+#include "MoveGeneration/AttackMaps.h"
+#include "MoveGeneration/BishopMap.h"
+#include "MoveGeneration/RookMap.h"
+#include "MoveGeneration/QueenMap.h"
+#include "MoveGeneration/KnightPattern.hpp"
+#include "MoveGeneration/KingPattern.hpp"
+#include "Board.hpp"
+#include "BitOperation.hpp"
+#include "PieceMap.hpp"
+
+#include <array>
+#include <string>
+
+
+namespace
+{
+    const std::array<std::string, 5> fens = {
+        "",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8"
+    };
+
+    // reference: one magic lookup per piece, with empty "us" set to keep defended squares
+    template<uint64_t (*Attacks)(const int, const uint64_t, const uint64_t)>
+    uint64_t sliderReference(uint64_t pieces, uint64_t occupied)
+    {
+        uint64_t res = 0;
+        while (pieces) res |= Attacks(pop_1st(pieces), 0, occupied);
+        return res;
+    }
+
+    uint64_t leaperReference(uint64_t pieces, const std::array<uint64_t, Board::boardSize> &table)
+    {
+        uint64_t res = 0;
+        while (pieces) res |= table[pop_1st(pieces)];
+        return res;
+    }
+
+    void expectSlidersMatch(const Board &board, const AttackMaps &maps, const std::string &fen)
+    {
+        const uint64_t occ = board.fullBoard();
+
+        for (pColor c : { pColor::White, pColor::Black })
+        {
+            const auto col = static_cast<size_t>(c);
+            EXPECT_EQ(maps.get(c, Piece::Bishop), sliderReference<Bishop::getMoves>(board.bitboards[6 + col], occ)) << fen;
+            EXPECT_EQ(maps.get(c, Piece::Rook),   sliderReference<Rook::getMoves>(board.bitboards[8 + col], occ)) << fen;
+            EXPECT_EQ(maps.get(c, Piece::Queen),  sliderReference<Queen::getMoves>(board.bitboards[10 + col], occ)) << fen;
+        }
+    }
+
+    // SIMD kernels are checked whenever the CPU has them, not only on BUILD_NATIVE_ARCH builds
+    void expectKernelMatches(AttackGen::Kernel kernel)
+    {
+        for (const auto &fen : fens)
+        {
+            Board board = TestUtils::loadBoard(fen);
+            const AttackMaps maps = AttackGen::computeWith(kernel, board);
+            expectSlidersMatch(board, maps, fen);
+
+            const AttackMaps scalar = AttackGen::computeScalar(board);
+            EXPECT_EQ(maps.byPiece, scalar.byPiece) << fen;
+            EXPECT_EQ(maps.byColor, scalar.byColor) << fen;
+        }
+    }
+}
+
+
+TEST(AttackMapsTest, SlidersMatchMagics)
+{
+    for (const auto &fen : fens)
+    {
+        Board board = TestUtils::loadBoard(fen);
+
+        for (const AttackMaps &maps : { AttackGen::compute(board), AttackGen::computeScalar(board) })
+        {
+            expectSlidersMatch(board, maps, fen);
+        }
+    }
+}
+
+TEST(AttackMapsTest, Avx2KernelMatchesMagics)
+{
+    if (!AttackGen::isSupported(AttackGen::Kernel::Avx2)) GTEST_SKIP() << "AVX2 kernel not available";
+
+    expectKernelMatches(AttackGen::Kernel::Avx2);
+}
+
+TEST(AttackMapsTest, Avx512KernelMatchesMagics)
+{
+    if (!AttackGen::isSupported(AttackGen::Kernel::Avx512)) GTEST_SKIP() << "AVX-512 kernel not available";
+
+    expectKernelMatches(AttackGen::Kernel::Avx512);
+}
+
+TEST(AttackMapsTest, LeapersAndUnions)
+{
+    for (const auto &fen : fens)
+    {
+        Board board = TestUtils::loadBoard(fen);
+        AttackMaps maps = AttackGen::compute(board);
+
+        for (pColor c : { pColor::White, pColor::Black })
+        {
+            const auto col = static_cast<size_t>(c);
+            EXPECT_EQ(maps.get(c, Piece::Knight), leaperReference(board.bitboards[4 + col], KnightPattern::attacksTo)) << fen;
+            EXPECT_EQ(maps.get(c, Piece::King),   leaperReference(board.bitboards[12 + col], KingPattern::attacksTo)) << fen;
+
+            uint64_t all = 0;
+            for (uint64_t att : maps.byPiece[col]) all |= att;
+            EXPECT_EQ(maps.get(c), all) << fen;
+        }
+
+        // start position pawns attack whole third/sixth rank
+        if (fen.empty())
+        {
+            EXPECT_EQ(maps.get(pColor::White, Piece::Pawn), 0xFFULL << 16);
+            EXPECT_EQ(maps.get(pColor::Black, Piece::Pawn), 0xFFULL << 40);
+        }
+    }
+}
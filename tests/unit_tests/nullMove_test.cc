@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+
+#include "testUtils.h"
+#include "Board.hpp"
+#include "PieceMap.hpp"
+
+#include <array>
+#include <string>
+
+
+TEST(NullMoveTest, KeyMatchesFreshHash)
+{
+    const std::array<std::string, 3> fens = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "rnbqkbnr/ppp1pppp/8/3pP3/8/8/PPPP1PPP/RNBQKBNR w KQkq d6 0 3",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R b KQkq - 0 1"
+    };
+
+    for (const auto &fen : fens)
+    {
+        Board board = TestUtils::loadBoard(fen);
+        board.makeNullMove();
+
+        EXPECT_EQ(board.enPassant, -1);
+        EXPECT_EQ(board.zobristKey, PieceMap::generatePosHash(board)) << fen;
+        EXPECT_TRUE(board.isLastMoveNull());
+    }
+}
+
+TEST(NullMoveTest, UnmakeRestoresState)
+{
+    Board board = TestUtils::loadBoard("rnbqkbnr/ppp1pppp/8/3pP3/8/8/PPPP1PPP/RNBQKBNR w KQkq d6 0 3");
+    const Board before = board;
+
+    board.makeNullMove();
+    EXPECT_EQ(board.sideToMove, pColor::Black);
+    EXPECT_EQ(board.bitboards, before.bitboards);
+
+    board.unmakeNullMove();
+    EXPECT_EQ(board.sideToMove, before.sideToMove);
+    EXPECT_EQ(board.enPassant, before.enPassant);
+    EXPECT_EQ(board.zobristKey, before.zobristKey);
+    EXPECT_EQ(board.halfMoveClock, before.halfMoveClock);
+    EXPECT_EQ(board.ply, before.ply);
+    EXPECT_FALSE(board.isLastMoveNull());
+}
@@ -0,0 +1,40 @@
+#include <gtest/gtest.h>
+
+#include "testUtils.h"
+#include "MoveGeneration/Perft/PerftFunctions.h"
+#include "MoveGeneration/Perft/PerftStats.h"
+#include "MoveGeneration/ChessRules.hpp"
+#include "Board.hpp"
+
+
+TEST(PerftTest, StartPositionShallow)
+{
+    Board board = TestUtils::loadBoard("");
+    ChessRules rules{board};
+
+    EXPECT_EQ(Perft(1, rules), 20);
+    EXPECT_EQ(Perft(2, rules), 400);
+    EXPECT_EQ(PerftDivide(2, rules), 400);
+}
+
+// "go perft 0" used to recurse until the board history overflowed
+TEST(PerftTest, NonPositiveDepthTerminates)
+{
+    Board board = TestUtils::loadBoard("");
+    ChessRules rules{board};
+
+    EXPECT_EQ(Perft(0, rules), 1);
+    EXPECT_EQ(Perft(-1, rules), 0);
+    EXPECT_EQ(PerftDivide(0, rules), 1);
+    EXPECT_EQ(PerftDivide(-1, rules), 0);
+    EXPECT_EQ(PerftDivideParallel(0, rules, 2), 1);
+    EXPECT_EQ(PerftDivideParallel(-3, rules, 2), 0);
+
+    PerftStats stats;
+    EXPECT_EQ(PerftDivide(0, rules, stats), 1);
+    EXPECT_EQ(PerftDivide(-1, rules, stats), 0);
+    EXPECT_EQ(stats.nodes, 1);
+
+    // the board is left untouched
+    EXPECT_EQ(Perft(1, rules), 20);
+}
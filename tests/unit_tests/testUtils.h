@@ -0,0 +1,30 @@
+// Copyright (c) 2025 Bartlomiej Kozka
+// All rights reserved.
+
+/*************** File description ****************/
+// Helpers shared by the unit tests
+/*************************************************/
+
+#ifndef TEST_UTILS_H
+#define TEST_UTILS_H
+
+#include "Board.hpp"
+#include "PieceMap.hpp"
+
+#include <string>
+
+
+namespace TestUtils
+{
+    // empty fen - start position
+    inline Board loadBoard(const std::string &fen)
+    {
+        PieceMap::init();
+        Board board{};
+        board.init();
+        board.loadFromFEN(fen);
+        return board;
+    }
+}
+
+#endif // TEST_UTILS_H
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+
+#include "Engine/TimeManager.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+
+TEST(TimeManagerTest, NoLimitsIsUnlimited)
+{
+    TimeManager tm;
+    tm.init(TimeLimits{});
+
+    EXPECT_FALSE(tm.isLimited());
+    EXPECT_FALSE(tm.stopAfterIteration(20, true, 500, 0, 100));
+}
+
+TEST(TimeManagerTest, MoveTimeIsFixed)
+{
+    TimeManager tm;
+    TimeLimits limits;
+    limits.moveTime = 1000;
+    limits.moveOverhead = 30;
+    tm.init(limits);
+
+    EXPECT_EQ(tm.optimum(), 970);
+    EXPECT_EQ(tm.maximum(), 970);
+    EXPECT_EQ(tm.softLimit(100, 0, 100), 970);
+}
+
+TEST(TimeManagerTest, ClockLimitsStayInsideRemainingTime)
+{
+    TimeManager tm;
+    TimeLimits limits;
+    limits.time = 60000;
+    limits.inc = 1000;
+    tm.init(limits);
+
+    EXPECT_EQ(tm.optimum(), 60000 / TimeManager::defaultMovesToGo + 750);
+    EXPECT_GT(tm.maximum(), tm.optimum());
+    EXPECT_LE(tm.maximum(), 60000 * TimeManager::maxTimeShare / 100);
+
+    // last move before the time control
+    limits.movesToGo = 1;
+    tm.init(limits);
+
+    EXPECT_LE(tm.optimum(), 60000 * TimeManager::maxTimeShare / 100);
+    EXPECT_LE(tm.maximum(), 60000 * TimeManager::maxTimeShare / 100);
+}
+
+TEST(TimeManagerTest, SoftLimitScales)
+{
+    TimeManager tm;
+    TimeLimits limits;
+    limits.time = 300000;
+    tm.init(limits);
+
+    // unstable best move, dropping score, nodes spread over the root moves
+    const int64_t unstable = tm.softLimit(50, 30, 100);
+    EXPECT_GT(unstable, tm.optimum());
+    EXPECT_LE(unstable, tm.maximum());
+
+    // the same best move for several iterations, one move takes almost all nodes
+    for (int depth = 1; depth <= 6; ++depth) (void)tm.stopAfterIteration(depth, false, 0, 95, 100);
+    EXPECT_LT(tm.softLimit(0, 95, 100), tm.optimum());
+}
+
+TEST(TimeManagerTest, TimerSetsStopFlag)
+{
+    TimeManager tm;
+    TimeLimits limits;
+    limits.moveTime = 50;
+    tm.init(limits);
+
+    std::atomic<bool> stop = false;
+    tm.start(stop);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    EXPECT_TRUE(stop);
+
+    tm.stop();
+}
+
+TEST(TimeManagerTest, StopCancelsTimer)
+{
+    TimeManager tm;
+    TimeLimits limits;
+    limits.moveTime = 100;
+    tm.init(limits);
+
+    std::atomic<bool> stop = false;
+    tm.start(stop);
+    tm.stop();
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    EXPECT_FALSE(stop);
+}
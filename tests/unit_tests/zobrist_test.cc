@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+
+#include "testUtils.h"
+#include "MoveGeneration/ChessRules.hpp"
+#include "MoveGeneration/MoveGenerator.h"
+#include "MoveGeneration/MoveParser/MoveParser.h"
+#include "Board.hpp"
+#include "PieceMap.hpp"
+
+#include <array>
+#include <string>
+#include <vector>
+
+
+// legal move in the uci notation, Move{0} if there is no such move
+static Move findMove(ChessRules &rules, const std::string &uci)
+{
+    std::array<Move, 256> moves;
+    const int movesCount = MoveGen::generateLegalMoves(rules, moves.data());
+
+    for (int i = 0; i < movesCount; ++i)
+    {
+        std::string moveStr = SimpleParser::moveToString(moves[i].OriginSq(), moves[i].TargetSq());
+        if (char promChar = SimpleParser::promotionTypeToChar(moves[i].getType()); promChar != '\0') moveStr += promChar;
+
+        if (moveStr == uci) return moves[i];
+    }
+    return Move{0};
+}
+
+// the incremental key has to match the fresh hash after every make and unmake
+static void checkSequence(const std::string &fen, const std::vector<std::string> &line)
+{
+    Board board = TestUtils::loadBoard(fen);
+    ChessRules rules{board};
+    ASSERT_EQ(board.zobristKey, PieceMap::generatePosHash(board)) << fen;
+
+    std::vector<uint64_t> keys;
+    for (const auto &uci : line)
+    {
+        Move move = findMove(rules, uci);
+        ASSERT_NE(static_cast<uint16_t>(move.getPackedMove()), 0) << fen << " " << uci;
+
+        keys.push_back(board.zobristKey);
+        board.makeMove(move);
+        EXPECT_EQ(board.zobristKey, PieceMap::generatePosHash(board)) << fen << " after " << uci;
+    }
+
+    for (auto it = line.rbegin(); it != line.rend(); ++it)
+    {
+        board.unmakeMove();
+        EXPECT_EQ(board.zobristKey, PieceMap::generatePosHash(board)) << fen << " undo " << *it;
+        EXPECT_EQ(board.zobristKey, keys.back()) << fen << " undo " << *it;
+        keys.pop_back();
+    }
+}
+
+TEST(ZobristTest, Castling)
+{
+    const std::string kiwipete = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
+
+    checkSequence(kiwipete, {"e1g1", "e8c8"});
+    checkSequence(kiwipete, {"e1c1", "e8g8"});
+    // rights lost by rook and king moves, rook captured on its square
+    checkSequence(kiwipete, {"a1b1", "h8h7", "e1d1", "a8b8"});
+    checkSequence(kiwipete, {"e2a6", "h3g2", "a6b7", "g2h1q"});
+    checkSequence(kiwipete, {"e2a6", "e7d8", "a6b7", "d8e7", "b7a8"});
+}
+
+TEST(ZobristTest, EnPassant)
+{
+    checkSequence("", {"e2e4", "a7a6", "e4e5", "d7d5", "e5d6", "c7d6"});
+    checkSequence("", {"a2a3", "d7d5", "a3a4", "d5d4", "e2e4", "d4e3", "d2e3"});
+    // double push without an en passant capture available
+    checkSequence("", {"e2e4", "e7e5", "g1f3", "b8c6"});
+}
+
+TEST(ZobristTest, Promotion)
+{
+    // quiet promotions, promotion captures on the rook squares
+    checkSequence("4k3/1P6/8/8/8/8/6p1/4K3 w - - 0 1", {"b7b8r", "e8e7", "e1d2", "g2g1n"});
+    checkSequence("r3k3/1P6/8/8/8/8/6p1/4K2R w Kq - 0 1", {"b7a8q", "e8e7", "e1d2", "g2h1b"});
+    checkSequence("r3k3/1P6/8/8/8/8/6p1/4K2R b Kq - 0 1", {"g2h1q", "e1e2", "a8a7", "b7b8n"});
+}